@@ -0,0 +1,12 @@
+#version 330 core
+in vec2 TexCoords;
+in vec3 SpriteColor;
+flat in float Layer;
+out vec4 color;
+
+uniform sampler2DArray image;
+
+void main()
+{
+    color = vec4(SpriteColor, 1.0) * texture(image, vec3(TexCoords, Layer));
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#version 330 core
+
+// <vec2 position, vec2 texCoords>
+layout (location = 0) in vec4 vertex;
+// <vec2 position, vec2 size>
+layout (location = 1) in vec4 instanceRect;
+// <vec3 color, float rotation in degrees>
+layout (location = 2) in vec4 instanceColorRotation;
+layout (location = 3) in float instanceLayer;
+
+out vec2 TexCoords;
+out vec3 SpriteColor;
+flat out float Layer;
+
+uniform mat4 projection;
+
+void main()
+{
+    vec2 size = instanceRect.zw;
+    float angle = radians(instanceColorRotation.w);
+    float c = cos(angle);
+    float s = sin(angle);
+
+    // same transform SpriteRenderer::DrawSprite builds on the CPU:
+    // scale, rotate about the sprite's center, then translate
+    vec2 local = vertex.xy * size - 0.5 * size;
+    local = vec2(c * local.x - s * local.y, s * local.x + c * local.y);
+    vec2 world = instanceRect.xy + 0.5 * size + local;
+
+    TexCoords = vertex.zw;
+    SpriteColor = instanceColorRotation.rgb;
+    Layer = instanceLayer;
+    gl_Position = projection * vec4(world, 0.0, 1.0);
+}
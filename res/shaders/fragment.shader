@@ -2,10 +2,11 @@
 in vec2 TexCoords;
 out vec4 color;
 
-uniform sampler2D image;
+uniform sampler2DArray image;
 uniform vec3 spriteColor;
+uniform float layer;
 
 void main()
 {    
-    color = vec4(spriteColor, 1.0) * texture(image, TexCoords);
+    color = vec4(spriteColor, 1.0) * texture(image, vec3(TexCoords, layer));
 }  
\ No newline at end of file
@@ -0,0 +1,11 @@
+#version 330 core
+in vec2 TexCoords;
+in vec4 GlyphColor;
+out vec4 color;
+
+uniform sampler2D font;
+
+void main()
+{
+    color = vec4(GlyphColor.rgb, GlyphColor.a * texture(font, TexCoords).r);
+}
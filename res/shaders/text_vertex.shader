@@ -0,0 +1,22 @@
+#version 330 core
+
+// <vec2 position, vec2 texCoords>
+layout (location = 0) in vec4 vertex;
+// <vec2 position, vec2 size>
+layout (location = 1) in vec4 instanceRect;
+// top left of the glyph's cell in the font atlas
+layout (location = 2) in vec2 instanceCell;
+layout (location = 3) in vec4 instanceColor;
+
+out vec2 TexCoords;
+out vec4 GlyphColor;
+
+uniform mat4 projection;
+uniform vec2 cellSize;
+
+void main()
+{
+    TexCoords = instanceCell + vertex.zw * cellSize;
+    GlyphColor = instanceColor;
+    gl_Position = projection * vec4(instanceRect.xy + vertex.xy * instanceRect.zw, 0.0, 1.0);
+}
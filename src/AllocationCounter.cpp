@@ -0,0 +1,69 @@
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+std::atomic<bool> AllocationCounter::s_Enabled(false);
+std::atomic<uint64_t> AllocationCounter::s_Count(0);
+
+void* CountedAllocate(std::size_t size)
+{
+    if (AllocationCounter::s_Enabled.load(std::memory_order_relaxed))
+        AllocationCounter::s_Count.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+// the array and nothrow forms are replaced too, so every allocation is counted
+// whichever form the standard library uses internally
+void* operator new(std::size_t size)
+{
+    void* p = CountedAllocate(size);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Counts calls to the global operator new, which this file's .cpp replaces.
+// Counting is off by default, and then an allocation costs one extra load
+// and a branch. --count-allocs turns it on to check that a rendered frame or
+// a simulation tick allocates nothing.
+class AllocationCounter
+{
+public:
+    static inline void SetEnabled(bool enabled) { s_Enabled.store(enabled, std::memory_order_relaxed); }
+    static inline bool IsEnabled() { return s_Enabled.load(std::memory_order_relaxed); }
+
+    // allocations on any thread while counting was on
+    static inline uint64_t GetCount() { return s_Count.load(std::memory_order_relaxed); }
+private:
+    static std::atomic<bool>     s_Enabled;
+    static std::atomic<uint64_t> s_Count;
+
+    friend void* CountedAllocate(std::size_t size);
+};
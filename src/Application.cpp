@@ -1,4 +1,10 @@
 #include <iostream>
+#include <string>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include <thread>
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
@@ -6,16 +12,163 @@
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 
+#include "AllocationCounter.h"
 #include "Game.h"
+#include "GLState.h"
+#include "Profiler.h"
+#include "TexturePack.h"
+#include "TextureArray.h"
+#include "Headless.h"
+#include "InputRecording.h"
 
 const unsigned int WINDOW_WIDTH = 800;
 const unsigned int WINDOW_HEIGHT = 600;
 
-void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mode);
+// the simulation runs at a fixed rate decoupled from rendering; these are the
+// defaults for --hz and --max-steps
+const unsigned int DEFAULT_SIMULATION_HZ = 240;
+const unsigned int DEFAULT_MAX_STEPS_PER_FRAME = 8;
 
 Game GameManager(WINDOW_WIDTH, WINDOW_HEIGHT);
 
-int main(void)
+#ifndef BREAKOUT_HEADLESS
+int runWindowed(unsigned int simulationHz, unsigned int maxStepsPerFrame, bool uncapped);
+void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mode);
+#endif
+
+int main(int argc, char** argv)
+{
+    bool headless = false;
+    unsigned int ticks = 0;
+    unsigned int simulationHz = DEFAULT_SIMULATION_HZ;
+    unsigned int maxStepsPerFrame = DEFAULT_MAX_STEPS_PER_FRAME;
+    bool uncapped = false;
+    const char* traceFile = nullptr;
+    const char* recordFile = nullptr;
+    const char* replayFile = nullptr;
+    unsigned int snapshotTick = NO_SNAPSHOT;
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    unsigned int batchGames = 0;
+    bool benchJobs = false;
+    unsigned int batchSteps = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg(argv[i]);
+        if (arg == "--headless")
+        {
+            headless = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+                ticks = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--hz" && i + 1 < argc)
+            simulationHz = std::max(1ul, std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--max-steps" && i + 1 < argc)
+            maxStepsPerFrame = std::max(1ul, std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--uncapped") // no v-sync, render as fast as possible
+            uncapped = true;
+        else if (arg == "--trace" && i + 1 < argc) // profiler trace written at exit
+            traceFile = argv[++i];
+        else if (arg == "--record" && i + 1 < argc) // input recording written at exit
+            recordFile = argv[++i];
+        else if (arg == "--replay" && i + 1 < argc)
+            replayFile = argv[++i];
+        else if (arg == "--snapshot-at" && i + 1 < argc) // with --replay, save and restore at a tick
+            snapshotTick = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--bench-batch") // optionally followed by the game and step counts
+        {
+            batchGames = 4096;
+            batchSteps = 1000;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+                batchGames = std::max(1ul, std::strtoul(argv[++i], nullptr, 10));
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+                batchSteps = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--balls" && i + 1 < argc)
+            GameManager.SetBallCount(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--threads" && i + 1 < argc)
+        {
+            threads = std::max(1ul, std::strtoul(argv[++i], nullptr, 10));
+            GameManager.SetThreadCount(threads);
+        }
+        else if (arg == "--level" && i + 1 < argc)
+            GameManager.SetLevelFile(argv[++i]);
+        else if (arg == "--count-allocs") // allocations per frame, or per tick headless
+            AllocationCounter::SetEnabled(true);
+        else if (arg == "--bench-jobs")
+            benchJobs = true;
+        else if (arg == "--bench-levels") // the rest of the arguments are level files
+            return RunLevelBenchmark(std::vector<std::string>(argv + i + 1, argv + argc));
+        else if (arg == "--pack-textures" && i + 2 < argc)
+        {
+            // every image in a directory to one sprite array pack, then exit
+            TexturePack pack;
+            bool packed = pack.Build(argv[i + 1]) && pack.Write(argv[i + 2]);
+            if (packed)
+                std::cout << "Packed " << pack.LayerCount() << " sprites" << std::endl;
+            return packed ? 0 : 1;
+        }
+        else if (arg == "--convert-level" && i + 2 < argc)
+        {
+            // text level to binary .lvl, then exit
+            bool converted = ConvertLevel(argv[i + 1], argv[i + 2]);
+            return converted ? 0 : 1;
+        }
+    }
+
+    if (replayFile)
+        return RunReplay(GameManager, replayFile, snapshotTick);
+    if (benchJobs)
+        return RunJobBenchmark(threads);
+    if (batchGames > 0)
+    {
+        // a game's zones cost more than its step, so they are only recorded when asked for
+        Profiler::SetEnabled(traceFile != nullptr);
+        int result = RunBatchBenchmark(batchGames, batchSteps, threads, 1.0f / simulationHz,
+            GameManager.GetLevelFile());
+        if (traceFile && Profiler::WriteChromeTrace(traceFile))
+            std::cout << "Wrote " << traceFile << std::endl;
+        return result;
+    }
+
+    InputRecording recording;
+    if (recordFile)
+    {
+        recording.Hz = simulationHz;
+        GameManager.SetRecording(&recording);
+    }
+
+    int result;
+#ifndef BREAKOUT_HEADLESS
+    if (!headless)
+        result = runWindowed(simulationHz, maxStepsPerFrame, uncapped);
+    else
+#else
+    (void)headless; // headless builds have no windowed mode to fall back to
+    (void)maxStepsPerFrame;
+    (void)uncapped;
+#endif
+    {
+        // one simulated hour unless told otherwise
+        if (ticks == 0)
+            ticks = 60 * 60 * simulationHz;
+        result = RunHeadless(GameManager, ticks, 1.0f / simulationHz);
+    }
+
+    if (traceFile && Profiler::WriteChromeTrace(traceFile))
+        std::cout << "Wrote " << traceFile << std::endl;
+    if (recordFile)
+    {
+        GameManager.SetRecording(nullptr);
+        if (recording.Write(recordFile))
+            std::cout << "Wrote " << recordFile << ", " << recording.TickCount() << " ticks" << std::endl;
+        else
+            std::cout << "RECORDING FAILED TO WRITE: " << recordFile << std::endl;
+    }
+    return result;
+}
+
+#ifndef BREAKOUT_HEADLESS
+int runWindowed(unsigned int simulationHz, unsigned int maxStepsPerFrame, bool uncapped)
 {
     if (!glfwInit())
         return -1;
@@ -36,7 +189,7 @@ int main(void)
 
     glfwSetKeyCallback(window, keyCallback);
 
-    glfwSwapInterval(1); // Enable v-sync
+    glfwSwapInterval(uncapped ? 0 : 1); // Enable v-sync unless benchmarking
 
     glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
 
@@ -51,30 +204,107 @@ int main(void)
         std::cout << "OpenGL: " << glGetString(GL_VERSION) << std::endl;
     }
 
-    GameManager.Init();
+    bool loaded = GameManager.Init(false, [window](unsigned int done, unsigned int total)
+    {
+        std::string title = "EPIC BREAKOUT | loading " + std::to_string(done) + "/" + std::to_string(total);
+        glfwSetWindowTitle(window, title.c_str());
+    });
+    if (!loaded)
+    {
+        glfwTerminate();
+        return -1;
+    }
+
+    // times are kept in double, a float clock loses step precision after a few hours
+    const double stepSeconds = 1.0 / simulationHz;
+    double accumulator = 0.0;
+    double lastFrame = glfwGetTime();
 
-    float deltaTime = 0.0f;
-    float lastFrame = 0.0f;
+    // frame counters shown in the window title once a second
+    double lastTitleUpdate = 0.0;
+    unsigned int framesSinceTitleUpdate = 0;
+    uint64_t allocationsAtTitleUpdate = AllocationCounter::GetCount();
+
+    // with --count-allocs, how many frames allocated at all and the worst one
+    unsigned int frames = 0, allocatingFrames = 0;
+    uint64_t mostFrameAllocations = 0;
 
     while (!glfwWindowShouldClose(window))
     {
-        float currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
+        PROFILE_ZONE("Frame");
+        uint64_t allocationsAtFrameStart = AllocationCounter::GetCount();
+        double currentFrame = glfwGetTime();
+        accumulator += currentFrame - lastFrame;
         lastFrame = currentFrame;
         glfwPollEvents();
 
-        GameManager.ProcessInput(deltaTime);
-        GameManager.Update(deltaTime);
+        // run as many fixed steps as the elapsed time covers; a hitch only means
+        // more steps, never a bigger dt
+        unsigned int steps = 0;
+        while (accumulator >= stepSeconds && steps < maxStepsPerFrame)
+        {
+            GameManager.Step(static_cast<float>(stepSeconds));
+            accumulator -= stepSeconds;
+            steps++;
+        }
+        // still behind after the cap: drop the backlog so we don't spiral, but keep
+        // the phase so the interpolation stays smooth
+        if (accumulator >= stepSeconds)
+            accumulator = std::fmod(accumulator, stepSeconds);
 
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
-        GameManager.Render((float)glfwGetTime());
+        GameManager.Render(static_cast<float>(accumulator / stepSeconds));
+
+        {
+            PROFILE_ZONE("SwapBuffers");
+            glfwSwapBuffers(window);
+        }
 
-        glfwSwapBuffers(window);
+        uint64_t frameAllocations = AllocationCounter::GetCount() - allocationsAtFrameStart;
+        frames++;
+        if (frameAllocations > 0)
+            allocatingFrames++;
+        mostFrameAllocations = std::max(mostFrameAllocations, frameAllocations);
+
+        framesSinceTitleUpdate++;
+        if (currentFrame - lastTitleUpdate >= 1.0)
+        {
+            const RenderStats& stats = GameManager.GetRenderStats();
+            const GLStateStats& state = GLState::GetStats();
+            // formatted in place, so the once-a-second update doesn't show up under --count-allocs
+            char title[512];
+            int length = std::snprintf(title, sizeof(title),
+                "EPIC BREAKOUT | %u fps | %u draw calls | %u sprites | %u/%u binds sent",
+                framesSinceTitleUpdate, stats.DrawCalls, stats.Sprites, state.Calls, state.Calls + state.Elided);
+            const std::vector<GpuTiming>& gpu = GameManager.GetGpuTimings();
+            if (!gpu.empty())
+                length += std::snprintf(title + length, sizeof(title) - length, " | gpu");
+            for (size_t i = 0; i < gpu.size() && length < static_cast<int>(sizeof(title)); ++i)
+                length += std::snprintf(title + length, sizeof(title) - length, " %s %.3fms",
+                    gpu[i].Name, gpu[i].Milliseconds);
+            if (AllocationCounter::IsEnabled() && length < static_cast<int>(sizeof(title)))
+            {
+                uint64_t allocations = AllocationCounter::GetCount() - allocationsAtTitleUpdate;
+                std::snprintf(title + length, sizeof(title) - length, " | %llu allocs/frame",
+                    static_cast<unsigned long long>(allocations / framesSinceTitleUpdate));
+                allocationsAtTitleUpdate = AllocationCounter::GetCount();
+            }
+            glfwSetWindowTitle(window, title);
+            lastTitleUpdate = currentFrame;
+            framesSinceTitleUpdate = 0;
+        }
 
         glfwPollEvents();
     }
 
+    TextureResidency textures = GameManager.GetTextureResidency();
+    std::cout << "Textures: " << textures.Layers << " layers resident (" << textures.Bytes / 1024
+        << " KiB)" << std::endl;
+    if (AllocationCounter::IsEnabled())
+        std::cout << "Allocations: " << allocatingFrames << " of " << frames
+            << " frames allocated, at most " << mostFrameAllocations << " in one frame" << std::endl;
+
     glfwTerminate();
     return 0;
 }
@@ -90,4 +320,5 @@ void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mode
         else if (action == GLFW_RELEASE)
             GameManager.SetKey(key, false);
     }
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
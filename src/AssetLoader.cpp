@@ -0,0 +1,43 @@
+#include "AssetLoader.h"
+
+#include <atomic>
+#include <thread>
+
+void AssetLoader::Add(const Job& job)
+{
+    m_Jobs.push_back(job);
+}
+
+void AssetLoader::Run(JobSystem* workers, const ProgressFunction& progress)
+{
+    unsigned int total = Size();
+    if (workers)
+    {
+        std::atomic<unsigned int> done(0);
+        JobCounter counter;
+        for (const Job& job : m_Jobs)
+            workers->Schedule([&job, &done]() { job(); done.fetch_add(1); }, &counter);
+
+        // help out rather than wait idle, reporting after each job run here
+        while (!counter.IsDone())
+        {
+            if (!workers->RunOne())
+                std::this_thread::yield();
+            else if (progress)
+                progress(done.load(), total);
+        }
+    }
+    else
+    {
+        for (unsigned int i = 0; i < total; ++i)
+        {
+            m_Jobs[i]();
+            if (progress)
+                progress(i + 1, total);
+        }
+    }
+
+    m_Jobs.clear();
+    if (progress)
+        progress(total, total);
+}
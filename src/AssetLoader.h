@@ -0,0 +1,28 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "JobSystem.h"
+
+// Runs a batch of CPU-side loading jobs (decoding, parsing) on a job system.
+// Jobs must not touch GL; the caller does the uploads once Run returns.
+// Every job is scheduled on its own, so a slow decode doesn't hold up a
+// whole chunk of quick ones.
+class AssetLoader
+{
+public:
+    typedef std::function<void()> Job;
+    // done out of total jobs finished
+    typedef std::function<void(unsigned int done, unsigned int total)> ProgressFunction;
+
+    void Add(const Job& job);
+    inline unsigned int Size() const { return static_cast<unsigned int>(m_Jobs.size()); }
+
+    // runs every job added so far and clears the list. progress is only called
+    // on the calling thread: after each job the caller ran itself, and once
+    // with done == total at the end. workers may be null to run everything inline.
+    void Run(JobSystem* workers, const ProgressFunction& progress = nullptr);
+private:
+    std::vector<Job> m_Jobs;
+};
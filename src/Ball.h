@@ -3,7 +3,6 @@
 #include "glm/glm.hpp"
 
 #include "Object.h"
-#include "Texture.h"
 
 class Ball : public Object
 {
@@ -11,9 +10,10 @@ public:
     // ball state	
     float     Radius;
     bool      Stuck;
+    // where the ball started the last step, so collision can use the swept bounds
+    glm::vec2 LastPosition;
 
-    Ball(glm::vec2 pos, float radius, glm::vec2 velocity, Texture sprite);
+    Ball(glm::vec2 pos, float radius, glm::vec2 velocity, unsigned int sprite);
 
-    glm::vec2 Move(float dt, unsigned int window_width);
     void      Reset(glm::vec2 position, glm::vec2 velocity);
 };
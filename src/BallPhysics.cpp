@@ -0,0 +1,136 @@
+#include "BallPhysics.h"
+
+#include <cmath>
+#include <limits>
+
+Direction VectorDirection(glm::vec2 target)
+{
+    glm::vec2 compass[] = {
+        glm::vec2(0.0f, 1.0f),	// up
+        glm::vec2(1.0f, 0.0f),	// right
+        glm::vec2(0.0f, -1.0f),	// down
+        glm::vec2(-1.0f, 0.0f)	// left
+    };
+    float max = 0.0f;
+    unsigned int best_match = -1;
+    for (unsigned int i = 0; i < 4; i++)
+    {
+        float dot_product = glm::dot(glm::normalize(target), compass[i]);
+        if (dot_product > max)
+        {
+            max = dot_product;
+            best_match = i;
+        }
+    }
+    return (Direction)best_match;
+}
+
+bool SweepCircleAABB(glm::vec2 center, glm::vec2 velocity, float radius,
+    glm::vec2 min, glm::vec2 max, float maxT, float& t)
+{
+    // the circle touches the box exactly when its center enters the box grown by the
+    // radius with rounded corners; start with the slabs of the square-cornered box
+    float tEnter = -std::numeric_limits<float>::infinity();
+    float tExit = std::numeric_limits<float>::infinity();
+    for (int axis = 0; axis < 2; ++axis)
+    {
+        float lo = min[axis] - radius;
+        float hi = max[axis] + radius;
+        if (velocity[axis] == 0.0f)
+        {
+            if (center[axis] < lo || center[axis] > hi)
+                return false;
+            continue;
+        }
+        float t1 = (lo - center[axis]) / velocity[axis];
+        float t2 = (hi - center[axis]) / velocity[axis];
+        if (t1 > t2)
+            std::swap(t1, t2);
+        tEnter = std::max(tEnter, t1);
+        tExit = std::min(tExit, t2);
+    }
+    if (tEnter > tExit || tEnter < 0.0f || tEnter > maxT)
+        return false;
+
+    // entering through a corner square means the real contact is with the corner circle
+    glm::vec2 hit = center + velocity * tEnter;
+    glm::vec2 corner(hit.x < min.x ? min.x : max.x, hit.y < min.y ? min.y : max.y);
+    bool cornerX = hit.x < min.x || hit.x > max.x;
+    bool cornerY = hit.y < min.y || hit.y > max.y;
+    if (cornerX && cornerY)
+    {
+        // solve |center + velocity * t - corner| = radius for the first root
+        glm::vec2 m = center - corner;
+        float a = glm::dot(velocity, velocity);
+        float b = glm::dot(m, velocity);
+        float c = glm::dot(m, m) - radius * radius;
+        float discriminant = b * b - a * c;
+        if (discriminant < 0.0f)
+            return false;
+        tEnter = (-b - std::sqrt(discriminant)) / a;
+        if (tEnter < 0.0f || tEnter > maxT)
+            return false;
+    }
+    t = tEnter;
+    return true;
+}
+
+
+void ResolveBrickContact(glm::vec2& position, glm::vec2& velocity, float radius, glm::vec2 difference)
+{
+    Direction dir = VectorDirection(difference);
+    if (dir == LEFT || dir == RIGHT) // horizontal collision
+    {
+        velocity.x = -velocity.x; // reverse horizontal velocity
+        // relocate
+        float penetration = radius - std::abs(difference.x);
+        if (dir == LEFT)
+            position.x += penetration; // move ball to right
+        else
+            position.x -= penetration; // move ball to left;
+    }
+    else // vertical collision
+    {
+        velocity.y = -velocity.y; // reverse vertical velocity
+        // relocate
+        float penetration = radius - std::abs(difference.y);
+        if (dir == UP)
+            position.y -= penetration; // move ball back up
+        else
+            position.y += penetration; // move ball back down
+    }
+}
+
+bool PaddleOverlap(glm::vec2 position, float radius, const Playfield& field) // AABB - Circle collision
+{
+    // get center point circle first 
+    glm::vec2 center(position + radius);
+    // calculate AABB info (center, half-extents)
+    glm::vec2 aabb_half_extents(field.PaddleSize.x / 2.0f, field.PaddleSize.y / 2.0f);
+    glm::vec2 aabb_center(
+        field.PaddlePosition.x + aabb_half_extents.x,
+        field.PaddlePosition.y + aabb_half_extents.y
+    );
+    // get difference vector between both centers
+    glm::vec2 difference = center - aabb_center;
+    glm::vec2 clamped = glm::clamp(difference, -aabb_half_extents, aabb_half_extents);
+    // add clamped value to AABB_center and we get the value of box closest to circle
+    glm::vec2 closest = aabb_center + clamped;
+    // retrieve vector between center circle and closest point AABB and check if length <= radius
+    difference = closest - center;
+    return glm::length(difference) <= radius;
+}
+
+void ResolvePaddleContact(glm::vec2 position, glm::vec2& velocity, float radius, const Playfield& field)
+{
+    // check where it hit the board, and change velocity based on where it hit the board
+    float centerBoard = field.PaddlePosition.x + field.PaddleSize.x / 2.0f;
+    float distance = (position.x + radius) - centerBoard;
+    float percentage = distance / (field.PaddleSize.x / 2.0f);
+    // then move accordingly
+    float strength = 2.0f;
+    glm::vec2 oldVelocity = velocity;
+    velocity.x = INITIAL_BALL_VELOCITY.x * percentage * strength;
+    velocity.y = -1.0f * abs(velocity.y); // THIS ONLY WORKS BECAUSE THE PADDLE IS AT THE BOTTOM
+    velocity = glm::normalize(velocity) * glm::length(oldVelocity);
+}
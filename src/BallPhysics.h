@@ -0,0 +1,234 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "Level.h"
+
+// Ball movement and collision on plain values, shared by Game, which moves any
+// number of balls through its own level, and BatchEnv, which moves one ball in
+// each of many games through one shared level. A ball is its top-left position,
+// its velocity and its radius. Which bricks are still live is up to the caller:
+// live(i) says whether brick i can be hit and hit(i) is called for every brick
+// the ball bounces off, so a caller can hold hits back or apply them at once.
+
+const glm::vec2 PLAYER_SIZE(100.0f, 10.0f);
+const float PLAYER_VELOCITY(500.0f);
+
+const float BALL_RADIUS = 12.5f;
+const glm::vec2 INITIAL_BALL_VELOCITY(200.0f, 300.0f);
+
+enum Direction {
+    UP,
+    RIGHT,
+    DOWN,
+    LEFT
+};
+
+// what a ball collides with besides the bricks: the side and top walls and the paddle
+struct Playfield
+{
+    float        Width;
+    const Level* Layout;
+    glm::vec2    PaddlePosition;
+    glm::vec2    PaddleSize;
+};
+
+// per-thread scratch for the brick queries
+struct BallScratch
+{
+    std::vector<BrickRange> Candidates;
+    // ball against brick or paddle tests made
+    uint64_t                Tests;
+};
+
+Direction VectorDirection(glm::vec2 target);
+
+// true if a circle at center moving by velocity * t first touches the box [min, max]
+// at some t in [0, maxT]; a circle that already overlaps the box is left to the
+// overlap check in CollideBall
+bool SweepCircleAABB(glm::vec2 center, glm::vec2 velocity, float radius,
+    glm::vec2 min, glm::vec2 max, float maxT, float& t);
+
+// reflects the ball off the side of a brick it overlaps and pushes it back out;
+// difference runs from the ball's center to the closest point of the brick
+void ResolveBrickContact(glm::vec2& position, glm::vec2& velocity, float radius, glm::vec2 difference);
+// true if the ball overlaps the paddle
+bool PaddleOverlap(glm::vec2 position, float radius, const Playfield& field);
+// sends the ball back up at an angle set by where on the paddle it landed
+void ResolvePaddleContact(glm::vec2 position, glm::vec2& velocity, float radius, const Playfield& field);
+
+enum ImpactType {
+    IMPACT_NONE,
+    IMPACT_WALL_LEFT,
+    IMPACT_WALL_RIGHT,
+    IMPACT_WALL_TOP,
+    IMPACT_BRICK,
+    IMPACT_PADDLE
+};
+
+// upper bound on how many times a ball can bounce within one step; what is left
+// of the step after that is moved through untested
+const unsigned int MAX_IMPACTS_PER_STEP = 8;
+
+// advances a ball through dt seconds with continuous collision against the
+// walls, the live bricks and the paddle, so it can't pass through anything
+template <typename Live, typename Hit>
+void SweepBall(glm::vec2& position, glm::vec2& velocity, float radius, float dt,
+    const Playfield& field, BallScratch& scratch, Live live, Hit hit)
+{
+    const Level& level = *field.Layout;
+    glm::vec2 size(radius * 2.0f, radius * 2.0f);
+    float remaining = dt;
+    ImpactType lastType = IMPACT_NONE;
+    unsigned int lastBrick = 0;
+    for (unsigned int impacts = 0; impacts < MAX_IMPACTS_PER_STEP && remaining > 0.0f; ++impacts)
+    {
+        // find the earliest time of impact over the rest of the step
+        glm::vec2 center = position + radius;
+        float firstTime = remaining;
+        ImpactType type = IMPACT_NONE;
+        unsigned int brick = 0;
+
+        if (velocity.x < 0.0f && (radius - center.x) / velocity.x < firstTime)
+        {
+            firstTime = std::max((radius - center.x) / velocity.x, 0.0f);
+            type = IMPACT_WALL_LEFT;
+        }
+        else if (velocity.x > 0.0f && (field.Width - radius - center.x) / velocity.x < firstTime)
+        {
+            firstTime = std::max((field.Width - radius - center.x) / velocity.x, 0.0f);
+            type = IMPACT_WALL_RIGHT;
+        }
+        if (velocity.y < 0.0f && (radius - center.y) / velocity.y < firstTime)
+        {
+            firstTime = std::max((radius - center.y) / velocity.y, 0.0f);
+            type = IMPACT_WALL_TOP;
+        }
+
+        glm::vec2 end = position + velocity * remaining;
+        scratch.Candidates.clear();
+        level.QueryBricks(glm::min(position, end), glm::max(position, end) + size, scratch.Candidates);
+        for (const BrickRange& range : scratch.Candidates)
+        {
+            scratch.Tests += range.End - range.Begin;
+            for (unsigned int i = range.Begin; i < range.End; ++i)
+            {
+                // the brick just resolved is touching the ball, don't hit it again at t = 0
+                if ((lastType == IMPACT_BRICK && lastBrick == i) || !live(i))
+                    continue;
+                float t;
+                glm::vec2 min(level.Bricks.MinX[i], level.Bricks.MinY[i]);
+                glm::vec2 max(level.Bricks.MaxX[i], level.Bricks.MaxY[i]);
+                if (SweepCircleAABB(center, velocity, radius, min, max, firstTime, t) && t < firstTime)
+                {
+                    firstTime = t;
+                    type = IMPACT_BRICK;
+                    brick = i;
+                }
+            }
+        }
+
+        float t;
+        scratch.Tests++;
+        if (lastType != IMPACT_PADDLE &&
+            SweepCircleAABB(center, velocity, radius, field.PaddlePosition,
+                field.PaddlePosition + field.PaddleSize, firstTime, t) && t < firstTime)
+        {
+            firstTime = t;
+            type = IMPACT_PADDLE;
+        }
+
+        // advance to the impact, or through the rest of the step if there is none
+        position += velocity * firstTime;
+        remaining -= firstTime;
+
+        if (type == IMPACT_NONE)
+            break;
+        if (type == IMPACT_WALL_LEFT)
+        {
+            velocity.x = -velocity.x;
+            position.x = 0.0f;
+        }
+        else if (type == IMPACT_WALL_RIGHT)
+        {
+            velocity.x = -velocity.x;
+            position.x = field.Width - size.x;
+        }
+        else if (type == IMPACT_WALL_TOP)
+        {
+            velocity.y = -velocity.y;
+            position.y = 0.0f;
+        }
+        else if (type == IMPACT_BRICK)
+        {
+            // at the moment of contact the usual overlap test holds, so hand the
+            // contact to the same resolution the overlap check uses
+            glm::vec2 contactCenter = position + radius;
+            if (!level.Bricks.IsSolid(brick))
+                hit(brick);
+            ResolveBrickContact(position, velocity, radius,
+                level.Bricks.ClosestPoint(brick, contactCenter) - contactCenter);
+        }
+        else if (type == IMPACT_PADDLE)
+            ResolvePaddleContact(position, velocity, radius, field);
+        lastType = type;
+        lastBrick = brick;
+    }
+
+    // out of impacts with time left: cover the rest of the step without testing
+    // it, so the ball never loses distance, and keep it inside the walls. Any
+    // brick it ends up overlapping is caught by the overlap check after
+    if (remaining > 0.0f)
+    {
+        position += velocity * remaining;
+        position.x = glm::clamp(position.x, 0.0f, field.Width - size.x);
+        position.y = std::max(position.y, 0.0f);
+    }
+}
+
+// resolves anything the ball overlaps after SweepBall, which moved it from
+// lastPosition. destroyed is the bitset the live bricks are searched in; live
+// can rule out more. A ball stuck to the paddle doesn't bounce off it
+template <typename Live, typename Hit>
+void CollideBall(glm::vec2& position, glm::vec2& velocity, float radius, glm::vec2 lastPosition,
+    bool stuck, const Playfield& field, const uint64_t* destroyed, BallScratch& scratch, Live live, Hit hit)
+{
+    const Level& level = *field.Layout;
+    glm::vec2 size(radius * 2.0f, radius * 2.0f);
+
+    // only bricks in cells touched by the ball's swept bounds can collide; pad by the
+    // radius since resolving one hit can push the ball toward a neighbouring cell
+    glm::vec2 sweptMin = glm::min(lastPosition, position) - radius;
+    glm::vec2 sweptMax = glm::max(lastPosition, position) + size + radius;
+    scratch.Candidates.clear();
+    level.QueryBricks(sweptMin, sweptMax, scratch.Candidates);
+
+    for (const BrickRange& range : scratch.Candidates)
+    {
+        scratch.Tests += range.End - range.Begin;
+        // FirstHit skips ahead to the next live brick the ball touches; resolving that
+        // hit moves the ball, so the search resumes after it from the new position
+        unsigned int i = range.Begin;
+        while ((i = level.Bricks.FirstHit(position + radius, radius, i, range.End, destroyed)) < range.End)
+        {
+            // same test as FirstHit, written against the closest point so they agree exactly
+            glm::vec2 center = position + radius;
+            glm::vec2 difference = level.Bricks.ClosestPoint(i, center) - center;
+            if (glm::length(difference) <= radius && live(i))
+            {
+                if (!level.Bricks.IsSolid(i))
+                    hit(i);
+                ResolveBrickContact(position, velocity, radius, difference);
+            }
+            ++i;
+        }
+    }
+
+    scratch.Tests++;
+    if (!stuck && PaddleOverlap(position, radius, field))
+        ResolvePaddleContact(position, velocity, radius, field);
+}
@@ -0,0 +1,129 @@
+#include "BatchEnv.h"
+
+#include "Profiler.h"
+
+// the game's own window size, which its layout and speeds are tuned for
+const unsigned int BATCH_GAME_WIDTH = 800;
+const unsigned int BATCH_GAME_HEIGHT = 600;
+// games are cheap to step; smaller runs than this aren't worth a thread
+const unsigned int MIN_GAMES_PER_THREAD = 16;
+
+BatchEnv::BatchEnv(unsigned int games, unsigned int threads, float dt, const std::string& levelFile)
+    : m_Games(games), m_Words(0), m_Workers(threads), m_Dt(dt), m_PaddleX(games), m_BallX(games),
+    m_BallY(games), m_VelocityX(games), m_VelocityY(games), m_Stuck(games), m_DestroyedCount(games),
+    m_Scratch(m_Workers.Size()), m_Observations(games * OBSERVATION_SIZE), m_Rewards(games),
+    m_Dones(games), m_Loaded(false)
+{
+    // the level is laid out like Game lays it out, in the top half of the screen
+    if (games == 0 || !m_Level.Load(levelFile.c_str(), BATCH_GAME_WIDTH, BATCH_GAME_HEIGHT / 2))
+        return;
+
+    m_Words = static_cast<unsigned int>(m_Level.Bricks.GetDestroyedWords().size());
+    m_Destroyed.resize(static_cast<size_t>(games) * m_Words);
+    for (unsigned int i = 0; i < games; ++i)
+    {
+        Reset(i);
+        Observe(i);
+    }
+    m_Loaded = true;
+}
+
+void BatchEnv::Reset(unsigned int game)
+{
+    std::fill_n(&m_Destroyed[game * m_Words], m_Words, uint64_t(0));
+    m_DestroyedCount[game] = 0;
+    m_PaddleX[game] = BATCH_GAME_WIDTH / 2.0f - PLAYER_SIZE.x / 2.0f;
+    m_BallX[game] = m_PaddleX[game] + PLAYER_SIZE.x * 0.5f - BALL_RADIUS;
+    m_BallY[game] = BATCH_GAME_HEIGHT - PLAYER_SIZE.y - BALL_RADIUS * 2.0f;
+    m_VelocityX[game] = INITIAL_BALL_VELOCITY.x;
+    m_VelocityY[game] = INITIAL_BALL_VELOCITY.y;
+    m_Stuck[game] = 1;
+}
+
+void BatchEnv::Step(const uint8_t* actions)
+{
+    PROFILE_ZONE("BatchStep");
+    m_Workers.ParallelFor(m_Games, MIN_GAMES_PER_THREAD,
+        [this, actions](unsigned int begin, unsigned int end, unsigned int thread)
+        {
+            BallScratch& scratch = m_Scratch[thread];
+            const float width = static_cast<float>(BATCH_GAME_WIDTH);
+            const float paddleY = BATCH_GAME_HEIGHT - PLAYER_SIZE.y;
+            const float move = PLAYER_VELOCITY * m_Dt;
+            for (unsigned int i = begin; i < end; ++i)
+            {
+                float paddleX = m_PaddleX[i];
+                glm::vec2 position(m_BallX[i], m_BallY[i]);
+                glm::vec2 velocity(m_VelocityX[i], m_VelocityY[i]);
+                bool stuck = m_Stuck[i] != 0;
+                glm::vec2 lastPosition = position;
+
+                // the paddle moves first and carries a stuck ball with it, as in Game::ProcessInput
+                if (actions[i] == ACTION_LEFT && paddleX >= 0.0f)
+                {
+                    paddleX -= move;
+                    if (stuck)
+                        position.x -= move;
+                }
+                if (actions[i] == ACTION_RIGHT && paddleX + PLAYER_SIZE.x <= width)
+                {
+                    paddleX += move;
+                    if (stuck)
+                        position.x += move;
+                }
+                if (actions[i] == ACTION_LAUNCH)
+                    stuck = false;
+
+                // with one ball per game a hit can be applied at once; the ball sees
+                // exactly the bricks a Game's ball sees through its held-back hits
+                uint64_t* destroyed = &m_Destroyed[i * m_Words];
+                unsigned int hits = 0;
+                auto live = [destroyed](unsigned int brick)
+                    { return !((destroyed[brick >> 6] >> (brick & 63)) & 1); };
+                auto hit = [destroyed, &hits](unsigned int brick)
+                {
+                    destroyed[brick >> 6] |= uint64_t(1) << (brick & 63);
+                    hits++;
+                };
+                Playfield field = { width, &m_Level, glm::vec2(paddleX, paddleY), PLAYER_SIZE };
+                if (!stuck)
+                    SweepBall(position, velocity, BALL_RADIUS, m_Dt, field, scratch, live, hit);
+                CollideBall(position, velocity, BALL_RADIUS, lastPosition, stuck, field, destroyed,
+                    scratch, live, hit);
+
+                bool lost = position.y >= BATCH_GAME_HEIGHT;
+                m_Rewards[i] = static_cast<float>(hits) - (lost ? 1.0f : 0.0f);
+                bool cleared = !lost && m_Level.Bricks.IsCleared(destroyed);
+                if (lost || cleared)
+                    Reset(i);
+                else
+                {
+                    m_PaddleX[i] = paddleX;
+                    m_BallX[i] = position.x;
+                    m_BallY[i] = position.y;
+                    m_VelocityX[i] = velocity.x;
+                    m_VelocityY[i] = velocity.y;
+                    m_Stuck[i] = stuck ? 1 : 0;
+                    m_DestroyedCount[i] += hits;
+                }
+                m_Dones[i] = lost || cleared ? 1 : 0;
+                Observe(i);
+            }
+        });
+}
+
+void BatchEnv::Observe(unsigned int game)
+{
+    float width = static_cast<float>(BATCH_GAME_WIDTH);
+    float height = static_cast<float>(BATCH_GAME_HEIGHT);
+    unsigned int bricks = m_Level.Bricks.Size();
+
+    float* observation = &m_Observations[game * OBSERVATION_SIZE];
+    observation[0] = m_PaddleX[game] / width;
+    observation[1] = m_BallX[game] / width;
+    observation[2] = m_BallY[game] / height;
+    observation[3] = m_VelocityX[game] / width;
+    observation[4] = m_VelocityY[game] / height;
+    observation[5] = m_Stuck[game] ? 1.0f : 0.0f;
+    observation[6] = bricks > 0 ? 1.0f - static_cast<float>(m_DestroyedCount[game]) / bricks : 0.0f;
+}
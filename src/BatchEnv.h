@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BallPhysics.h"
+#include "JobSystem.h"
+#include "Level.h"
+
+// what one game does for a step, held until the next Step
+enum BatchAction : uint8_t
+{
+    ACTION_NONE,
+    ACTION_LEFT,
+    ACTION_RIGHT,
+    ACTION_LAUNCH
+};
+
+// Steps many independent headless games in lockstep for automated play and
+// balancing. Every game plays the same level with one ball, so the level is
+// parsed once and its brick layout and grid are shared; what differs between
+// games is kept as structure-of-arrays indexed by game: the paddle, the ball
+// and a destroyed bitset per game. Step is one kernel over those arrays, split
+// across a job system in contiguous ranges of games, so every game is stepped
+// by one thread and results don't depend on the thread count. The physics is
+// the same BallPhysics code Game uses, so a game here plays exactly like a
+// Game with one ball. Actions go in as one array and observations, rewards
+// and done flags come back as contiguous arrays indexed by game. An episode
+// ends when a life is lost or when every breakable brick is destroyed; either
+// way the game resets, so its next observation is the start of a new episode.
+class BatchEnv
+{
+public:
+    // per game: paddle x, ball x, y, velocity x, y, whether it is stuck to the
+    // paddle, and the fraction of bricks left. Positions are in [0, 1] of the
+    // screen, velocities in screens per second
+    static const unsigned int OBSERVATION_SIZE = 7;
+private:
+    // the level every game plays; its own destroyed flags are never set
+    Level              m_Level;
+    unsigned int       m_Games;
+    // destroyed bitset words per game
+    unsigned int       m_Words;
+    JobSystem          m_Workers;
+    float              m_Dt;
+
+    // per-game state, one element per game
+    std::vector<float>        m_PaddleX;
+    std::vector<float>        m_BallX, m_BallY;
+    std::vector<float>        m_VelocityX, m_VelocityY;
+    std::vector<uint8_t>      m_Stuck;
+    std::vector<unsigned int> m_DestroyedCount;
+    // m_Words per game, game by game
+    std::vector<uint64_t>     m_Destroyed;
+    // per-thread scratch for the brick queries
+    std::vector<BallScratch>  m_Scratch;
+
+    std::vector<float>   m_Observations;
+    std::vector<float>   m_Rewards;
+    std::vector<uint8_t> m_Dones;
+    bool                 m_Loaded;
+
+    // brings the bricks back and puts the ball on the paddle, as Game does for a new life
+    void Reset(unsigned int game);
+    void Observe(unsigned int game);
+public:
+    // every game plays levelFile with one ball and steps dt seconds per Step
+    BatchEnv(unsigned int games, unsigned int threads, float dt,
+        const std::string& levelFile = "res/levels/lvl1.txt");
+
+    // false if the level failed to load; nothing may be stepped then
+    inline bool IsLoaded() const { return m_Loaded; }
+
+    BatchEnv(const BatchEnv&) = delete;
+    BatchEnv& operator=(const BatchEnv&) = delete;
+
+    inline unsigned int Size() const { return m_Games; }
+
+    // actions holds one BatchAction per game. The reward is the bricks destroyed
+    // in the step, less one if the life was lost; done is set when the life was
+    // lost or the level cleared
+    void Step(const uint8_t* actions);
+
+    // games * OBSERVATION_SIZE floats, game by game
+    inline const float* Observations() const { return m_Observations.data(); }
+    inline const float* Rewards() const { return m_Rewards.data(); }
+    inline const uint8_t* Dones() const { return m_Dones.data(); }
+    // the level shared by every game, and one game's destroyed bitset laid out like its bricks'
+    inline const Level& GetLevel() const { return m_Level; }
+    inline const uint64_t* GetDestroyedWords(unsigned int game) const { return &m_Destroyed[game * m_Words]; }
+};
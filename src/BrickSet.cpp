@@ -0,0 +1,150 @@
+#include "BrickSet.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define BRICKSET_AVX
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BRICKSET_SSE2
+#endif
+
+static unsigned int LowestBit(unsigned int mask)
+{
+    unsigned int bit = 0;
+    while (!(mask & 1))
+    {
+        mask >>= 1;
+        bit++;
+    }
+    return bit;
+}
+
+void BrickSet::Clear()
+{
+    MinX.clear();
+    MinY.clear();
+    MaxX.clear();
+    MaxY.clear();
+    ColorIndex.clear();
+    m_Destroyed.clear();
+    m_Solid.clear();
+}
+
+void BrickSet::Add(glm::vec2 position, glm::vec2 size, unsigned char colorIndex, bool solid)
+{
+    unsigned int i = Size();
+    MinX.push_back(position.x);
+    MinY.push_back(position.y);
+    MaxX.push_back(position.x + size.x);
+    MaxY.push_back(position.y + size.y);
+    ColorIndex.push_back(colorIndex);
+
+    if ((i & 63) == 0)
+    {
+        m_Destroyed.push_back(0);
+        m_Solid.push_back(0);
+    }
+    if (solid)
+        m_Solid[i >> 6] |= uint64_t(1) << (i & 63);
+}
+
+void BrickSet::ClearDestroyed()
+{
+    std::fill(m_Destroyed.begin(), m_Destroyed.end(), uint64_t(0));
+}
+
+void BrickSet::SetDestroyedWords(const uint64_t* words)
+{
+    std::copy(words, words + m_Destroyed.size(), m_Destroyed.begin());
+}
+
+unsigned int BrickSet::DestroyedCount() const
+{
+    unsigned int count = 0;
+    for (uint64_t word : m_Destroyed)
+    {
+        // clear the lowest set bit until none are left
+        for (; word; word &= word - 1)
+            count++;
+    }
+    return count;
+}
+
+bool BrickSet::IsCleared(const uint64_t* destroyed) const
+{
+    for (size_t i = 0; i < m_Destroyed.size(); ++i)
+    {
+        // bits past the last brick are neither destroyed nor solid
+        unsigned int bricks = std::min(64u, Size() - static_cast<unsigned int>(i) * 64);
+        uint64_t mask = bricks == 64 ? ~uint64_t(0) : (uint64_t(1) << bricks) - 1;
+        if (((destroyed[i] | m_Solid[i]) & mask) != mask)
+            return false;
+    }
+    return true;
+}
+
+unsigned int BrickSet::DestroyedBits(const uint64_t* destroyed, unsigned int index, unsigned int count) const
+{
+    unsigned int word = index >> 6;
+    unsigned int shift = index & 63;
+    uint64_t bits = destroyed[word] >> shift;
+    // the run straddles two words
+    if (shift + count > 64 && word + 1 < m_Destroyed.size())
+        bits |= destroyed[word + 1] << (64 - shift);
+    return static_cast<unsigned int>(bits & ((1u << count) - 1));
+}
+
+unsigned int BrickSet::FirstHit(glm::vec2 center, float radius, unsigned int begin, unsigned int end,
+    const uint64_t* destroyed) const
+{
+    unsigned int i = begin;
+
+#ifdef BRICKSET_AVX
+    __m256 cx8 = _mm256_set1_ps(center.x);
+    __m256 cy8 = _mm256_set1_ps(center.y);
+    __m256 r8 = _mm256_set1_ps(radius);
+    for (; i + 8 <= end; i += 8)
+    {
+        __m256 px = _mm256_min_ps(_mm256_max_ps(cx8, _mm256_loadu_ps(&MinX[i])), _mm256_loadu_ps(&MaxX[i]));
+        __m256 py = _mm256_min_ps(_mm256_max_ps(cy8, _mm256_loadu_ps(&MinY[i])), _mm256_loadu_ps(&MaxY[i]));
+        __m256 dx = _mm256_sub_ps(px, cx8);
+        __m256 dy = _mm256_sub_ps(py, cy8);
+        __m256 dist = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+        unsigned int hits = _mm256_movemask_ps(_mm256_cmp_ps(dist, r8, _CMP_LE_OQ)) & ~DestroyedBits(destroyed, i, 8);
+        if (hits)
+            return i + LowestBit(hits);
+    }
+#endif
+
+#ifdef BRICKSET_SSE2
+    __m128 cx4 = _mm_set1_ps(center.x);
+    __m128 cy4 = _mm_set1_ps(center.y);
+    __m128 r4 = _mm_set1_ps(radius);
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 px = _mm_min_ps(_mm_max_ps(cx4, _mm_loadu_ps(&MinX[i])), _mm_loadu_ps(&MaxX[i]));
+        __m128 py = _mm_min_ps(_mm_max_ps(cy4, _mm_loadu_ps(&MinY[i])), _mm_loadu_ps(&MaxY[i]));
+        __m128 dx = _mm_sub_ps(px, cx4);
+        __m128 dy = _mm_sub_ps(py, cy4);
+        __m128 dist = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+        unsigned int hits = _mm_movemask_ps(_mm_cmple_ps(dist, r4)) & ~DestroyedBits(destroyed, i, 4);
+        if (hits)
+            return i + LowestBit(hits);
+    }
+#endif
+
+    // scalar tail, and the whole range on targets without SSE2
+    for (; i < end; ++i)
+    {
+        if ((destroyed[i >> 6] >> (i & 63)) & 1)
+            continue;
+        glm::vec2 difference = ClosestPoint(i, center) - center;
+        if (std::sqrt(difference.x * difference.x + difference.y * difference.y) <= radius)
+            return i;
+    }
+    return end;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+// a run of consecutive brick indices [Begin, End)
+struct BrickRange
+{
+    unsigned int Begin, End;
+};
+
+// Data-oriented brick storage. Bounds live in separate arrays and the
+// destroyed/solid flags are packed bitsets, so collision streams only the
+// bytes it needs and a large level stays small enough to remain in cache.
+class BrickSet
+{
+private:
+    std::vector<uint64_t> m_Destroyed;
+    std::vector<uint64_t> m_Solid;
+
+    // flags for [index, index + count) of a destroyed bitset in the low bits, count <= 8
+    unsigned int DestroyedBits(const uint64_t* destroyed, unsigned int index, unsigned int count) const;
+public:
+    std::vector<float>         MinX, MinY, MaxX, MaxY;
+    std::vector<unsigned char> ColorIndex;
+
+    void Clear();
+    void Add(glm::vec2 position, glm::vec2 size, unsigned char colorIndex, bool solid);
+
+    inline unsigned int Size() const { return static_cast<unsigned int>(MinX.size()); }
+    inline bool IsDestroyed(unsigned int i) const { return (m_Destroyed[i >> 6] >> (i & 63)) & 1; }
+    inline bool IsSolid(unsigned int i) const { return (m_Solid[i >> 6] >> (i & 63)) & 1; }
+    inline void SetDestroyed(unsigned int i) { m_Destroyed[i >> 6] |= uint64_t(1) << (i & 63); }
+    // brings every brick back; the layout itself never changes after loading
+    void ClearDestroyed();
+    unsigned int DestroyedCount() const;
+    // every brick that can be destroyed has been; solid ones never are
+    inline bool IsCleared() const { return IsCleared(m_Destroyed.data()); }
+    // the same for a bitset laid out like GetDestroyedWords, so many games can
+    // share one layout and keep only their own destroyed bits
+    bool IsCleared(const uint64_t* destroyed) const;
+    // the destroyed bitset, 64 bricks per word
+    inline const std::vector<uint64_t>& GetDestroyedWords() const { return m_Destroyed; }
+    // replaces the bitset with as many words as GetDestroyedWords has
+    void SetDestroyedWords(const uint64_t* words);
+
+    inline glm::vec2 Position(unsigned int i) const { return glm::vec2(MinX[i], MinY[i]); }
+    inline glm::vec2 Size(unsigned int i) const { return glm::vec2(MaxX[i] - MinX[i], MaxY[i] - MinY[i]); }
+
+    // point of brick i closest to p
+    inline glm::vec2 ClosestPoint(unsigned int i, glm::vec2 p) const
+    {
+        return glm::vec2(glm::min(glm::max(p.x, MinX[i]), MaxX[i]),
+                         glm::min(glm::max(p.y, MinY[i]), MaxY[i]));
+    }
+
+    // index of the first live brick in [begin, end) touched by the circle, or end
+    // if there is none. Tests 8 bricks per step with AVX and 4 with SSE2; every
+    // path uses the same arithmetic as ClosestPoint so they agree bit for bit.
+    inline unsigned int FirstHit(glm::vec2 center, float radius, unsigned int begin, unsigned int end) const
+    {
+        return FirstHit(center, radius, begin, end, m_Destroyed.data());
+    }
+    // the same against a destroyed bitset laid out like GetDestroyedWords
+    unsigned int FirstHit(glm::vec2 center, float radius, unsigned int begin, unsigned int end,
+        const uint64_t* destroyed) const;
+};
@@ -0,0 +1,114 @@
+#include "GLState.h"
+
+// ~0u is never a valid GL name, so it marks a binding we don't know
+static const unsigned int UNKNOWN = ~0u;
+
+static unsigned int s_Program = UNKNOWN;
+static unsigned int s_ActiveUnit = UNKNOWN;
+static unsigned int s_Texture2D[GLState::TEXTURE_UNITS];
+static unsigned int s_Texture2DArray[GLState::TEXTURE_UNITS];
+static unsigned int s_VertexArray = UNKNOWN;
+static bool s_TexturesKnown = false;
+static GLStateStats s_Stats = {};
+
+// true if value had to change, i.e. the GL call must be made
+static bool Update(unsigned int& cached, unsigned int value)
+{
+    if (cached == value)
+    {
+        s_Stats.Elided++;
+        return false;
+    }
+    cached = value;
+    s_Stats.Calls++;
+    return true;
+}
+
+static unsigned int* TextureBindings(GLenum target)
+{
+    // the tables start out zeroed, which would read as "0 is bound"
+    if (!s_TexturesKnown)
+        GLState::Invalidate();
+    return target == GL_TEXTURE_2D_ARRAY ? s_Texture2DArray : s_Texture2D;
+}
+
+void GLState::UseProgram(unsigned int program)
+{
+    if (Update(s_Program, program))
+        glUseProgram(program);
+}
+
+void GLState::ActiveTexture(unsigned int unit)
+{
+    if (Update(s_ActiveUnit, unit))
+        glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+void GLState::BindTexture(GLenum target, unsigned int texture)
+{
+    unsigned int* bindings = TextureBindings(target);
+    // units past what we track are always bound for real
+    if (s_ActiveUnit >= TEXTURE_UNITS)
+    {
+        s_Stats.Calls++;
+        glBindTexture(target, texture);
+        return;
+    }
+    if (Update(bindings[s_ActiveUnit], texture))
+        glBindTexture(target, texture);
+}
+
+void GLState::BindVertexArray(unsigned int vao)
+{
+    if (Update(s_VertexArray, vao))
+        glBindVertexArray(vao);
+}
+
+void GLState::DeleteProgram(unsigned int program)
+{
+    // a deleted program stays in use until another one is made current, so
+    // the next UseProgram must not be skipped even if the name comes back
+    if (s_Program == program)
+        s_Program = UNKNOWN;
+    glDeleteProgram(program);
+}
+
+void GLState::DeleteTexture(unsigned int texture)
+{
+    TextureBindings(GL_TEXTURE_2D);
+    for (unsigned int unit = 0; unit < TEXTURE_UNITS; ++unit)
+    {
+        if (s_Texture2D[unit] == texture)
+            s_Texture2D[unit] = 0;
+        if (s_Texture2DArray[unit] == texture)
+            s_Texture2DArray[unit] = 0;
+    }
+    glDeleteTextures(1, &texture);
+}
+
+void GLState::DeleteVertexArray(unsigned int vao)
+{
+    if (s_VertexArray == vao)
+        s_VertexArray = 0;
+    glDeleteVertexArrays(1, &vao);
+}
+
+void GLState::Invalidate()
+{
+    s_Program = UNKNOWN;
+    s_ActiveUnit = UNKNOWN;
+    s_VertexArray = UNKNOWN;
+    for (unsigned int unit = 0; unit < TEXTURE_UNITS; ++unit)
+        s_Texture2D[unit] = s_Texture2DArray[unit] = UNKNOWN;
+    s_TexturesKnown = true;
+}
+
+void GLState::ResetStats()
+{
+    s_Stats = GLStateStats();
+}
+
+const GLStateStats& GLState::GetStats()
+{
+    return s_Stats;
+}
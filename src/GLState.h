@@ -0,0 +1,37 @@
+#pragma once
+
+#include <GL/glew.h>
+
+struct GLStateStats
+{
+    unsigned int Calls;   // state changes that reached the driver
+    unsigned int Elided;  // state changes skipped because nothing changed
+};
+
+// Shadows the bits of GL binding state the game touches, so binding what is
+// already bound never reaches the driver. Every bind of these kinds has to go
+// through here, and objects have to be deleted through here, or the shadow
+// copy goes stale. There is one GL context, so the state is global.
+class GLState
+{
+public:
+    static const unsigned int TEXTURE_UNITS = 16;
+
+    static void UseProgram(unsigned int program);
+    // unit is 0-based, not GL_TEXTUREi
+    static void ActiveTexture(unsigned int unit);
+    // binds to the active unit; target is GL_TEXTURE_2D or GL_TEXTURE_2D_ARRAY
+    static void BindTexture(GLenum target, unsigned int texture);
+    static void BindVertexArray(unsigned int vao);
+
+    // deleting a bound object unbinds it in GL, these keep the shadow in step
+    static void DeleteProgram(unsigned int program);
+    static void DeleteTexture(unsigned int texture);
+    static void DeleteVertexArray(unsigned int vao);
+
+    // forget everything, for after code that changed state behind our back
+    static void Invalidate();
+
+    static void ResetStats();
+    static const GLStateStats& GetStats();
+};
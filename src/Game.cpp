@@ -1,4 +1,6 @@
 #include <iostream>
+#include <algorithm>
+#include <cstring>
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
@@ -8,90 +10,284 @@
 
 #include "Game.h"
 #include "Shader.h"
-#include "Texture.h"
+#include "TextureArray.h"
+#include "TexturePack.h"
 #include "SpriteRenderer.h"
 #include "Level.h"
 #include "Ball.h"
+#include "Profiler.h"
+#include "GpuTimer.h"
+#include "Hud.h"
 
-SpriteRenderer* Renderer;
+// made by --pack-textures; without it the images are packed at startup
+const char* SPRITE_PACK_FILE = "res/textures/sprites.pak";
+const char* SPRITE_DIRECTORY = "res/textures";
 
-Object* Player;
-const glm::vec2 PLAYER_SIZE(100.0f, 10.0f);
-const float PLAYER_VELOCITY(500.0f);
+// SplitBalls stops doubling past this
+const unsigned int MAX_BALLS = 65536;
+// fewer balls than this per thread aren't worth handing to a worker
+const unsigned int MIN_BALLS_PER_THREAD = 64;
 
-const float BALL_RADIUS = 12.5f;
-const glm::vec2 INITIAL_BALL_VELOCITY(200.0f, 300.0f);
-
-Ball* BallObject;
+// where P writes the profiler trace, in the working directory
+const char* TRACE_FILE = "trace.json";
 
 Game::Game(unsigned int width, unsigned int height)
-    : m_State(GAME_ACTIVE), m_Keys(), m_Width(width), m_Height(height)
+    : m_State(GAME_ACTIVE), m_Width(width), m_Height(height), m_Keys(), m_KeysProcessed(),
+    m_CurrLevel(0), m_Batching(true), m_Headless(false), m_GpuTiming(false), m_ShowHud(false),
+    m_CollisionTests(0), m_BricksDestroyed(0), m_LivesLost(0), m_BallCount(1),
+    m_LevelFile("res/levels/lvl1.txt"), m_Recording(nullptr),
+    m_ThreadCount(std::max(1u, std::thread::hardware_concurrency())), m_Workers(nullptr),
+    m_Player(glm::vec2(0.0f), PLAYER_SIZE, 0), m_Renderer(nullptr), m_Streamer(nullptr),
+    m_Sprites(nullptr), m_PassTimer(nullptr), m_Overlay(nullptr), m_BrickSprite(0),
+    m_PaddleSprite(0), m_BallSprite(0)
 {
 
 }
 
 Game::~Game()
 {
-    delete Renderer;
+    delete m_Workers;
+#ifndef BREAKOUT_HEADLESS
+    delete m_Renderer;
+    delete m_PassTimer;
+    delete m_Overlay;
+    delete m_Sprites;
+    delete m_Streamer;
+#endif
 }
 
-void Game::Init()
+void Game::SetBallCount(unsigned int count)
 {
-    Shader spriteShader("res/shaders/vertex.shader", "res/shaders/fragment.shader");
-    glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(m_Width),
-        static_cast<float>(m_Height), 0.0f, -1.0f, 1.0f);
-    spriteShader.SetUniform1i("image", 0);
-    spriteShader.SetUniformMat4f("projection", projection);
-    Renderer = new SpriteRenderer(spriteShader);
+    m_BallCount = std::max(1u, std::min(count, MAX_BALLS));
+}
 
-    Level one;
-    one.Load("res/levels/lvl1.txt", m_Width, m_Height / 2);
-    m_Levels.push_back(one);
-    m_CurrLevel = 0;
+void Game::SetThreadCount(unsigned int threads)
+{
+    m_ThreadCount = std::max(1u, threads);
+}
 
-    Texture Paddle = Texture("res/textures/paddle.png");
-    glm::vec2 playerPos = glm::vec2(
-        m_Width / 2.0f - PLAYER_SIZE.x / 2.0f,
-        m_Height - PLAYER_SIZE.y
-    );
-    Player = new Object(playerPos, PLAYER_SIZE, Paddle, glm::vec3(1.0f));
+void Game::SetRecording(InputRecording* recording)
+{
+    m_Recording = recording;
+    if (!recording)
+        return;
+    recording->Width = m_Width;
+    recording->Height = m_Height;
+    recording->BallCount = m_BallCount;
+    recording->LevelFile = m_LevelFile;
+}
+
+// FNV-1a over the raw bytes, so a difference in the last bit of a float shows
+static void HashBytes(uint32_t& hash, const void* data, size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+}
 
-    glm::vec2 ballPos = playerPos + glm::vec2(PLAYER_SIZE.x / 2.0f - BALL_RADIUS,
-        -BALL_RADIUS * 2.0f);
-    BallObject = new Ball(ballPos, BALL_RADIUS, INITIAL_BALL_VELOCITY,
-        Texture("res/textures/ball.png"));
+uint32_t Game::StateHash() const
+{
+    uint32_t hash = 2166136261u;
+    HashBytes(hash, &m_State, sizeof(m_State));
+    HashBytes(hash, &m_CurrLevel, sizeof(m_CurrLevel));
+    HashBytes(hash, &m_Player.Position, sizeof(m_Player.Position));
+    HashBytes(hash, &m_Player.Size, sizeof(m_Player.Size));
+    for (const Ball& ball : m_Balls)
+    {
+        HashBytes(hash, &ball.Position, sizeof(ball.Position));
+        HashBytes(hash, &ball.Velocity, sizeof(ball.Velocity));
+        HashBytes(hash, &ball.Stuck, sizeof(ball.Stuck));
+    }
+    const std::vector<uint64_t>& destroyed = m_Levels[m_CurrLevel].Bricks.GetDestroyedWords();
+    HashBytes(hash, destroyed.data(), destroyed.size() * sizeof(uint64_t));
+    return hash;
 }
 
-enum Direction {
-    UP,
-    RIGHT,
-    DOWN,
-    LEFT
+// snapshot layout: the header, BallCount BallSnapshots, then BrickWords words of
+// the destroyed bitset
+struct SnapshotHeader
+{
+    uint32_t  State;
+    uint32_t  Level;
+    uint32_t  BallCount;
+    uint32_t  BrickWords;
+    glm::vec2 PlayerPosition;
+    glm::vec2 PlayerSize;
+    glm::vec2 PrevPlayerPosition;
+    // m_Keys and m_KeysProcessed as bitsets
+    uint64_t  Keys[1024 / 64];
+    uint64_t  KeysProcessed[1024 / 64];
 };
 
-Direction VectorDirection(glm::vec2 target)
-{
-    glm::vec2 compass[] = {
-        glm::vec2(0.0f, 1.0f),	// up
-        glm::vec2(1.0f, 0.0f),	// right
-        glm::vec2(0.0f, -1.0f),	// down
-        glm::vec2(-1.0f, 0.0f)	// left
-    };
-    float max = 0.0f;
-    unsigned int best_match = -1;
-    for (unsigned int i = 0; i < 4; i++)
+struct BallSnapshot
+{
+    glm::vec2 Position;
+    glm::vec2 Velocity;
+    glm::vec2 LastPosition;
+    float     Radius;
+    uint32_t  Stuck;
+};
+// the bitset is handed to the level in place, so it has to stay 8-byte aligned
+static_assert(sizeof(SnapshotHeader) % 8 == 0 && sizeof(BallSnapshot) % 8 == 0,
+    "snapshot sections must keep the brick words aligned");
+
+static void PackBits(const bool* bits, uint64_t* words, unsigned int count)
+{
+    for (unsigned int i = 0; i < count / 64; ++i)
     {
-        float dot_product = glm::dot(glm::normalize(target), compass[i]);
-        if (dot_product > max)
-        {
-            max = dot_product;
-            best_match = i;
-        }
+        uint64_t word = 0;
+        for (unsigned int bit = 0; bit < 64; ++bit)
+            word |= static_cast<uint64_t>(bits[i * 64 + bit]) << bit;
+        words[i] = word;
+    }
+}
+
+static void UnpackBits(const uint64_t* words, bool* bits, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i)
+        bits[i] = (words[i >> 6] >> (i & 63)) & 1;
+}
+
+void Game::Save(GameSnapshot& snapshot) const
+{
+    const std::vector<uint64_t>& destroyed = m_Levels[m_CurrLevel].Bricks.GetDestroyedWords();
+    snapshot.m_Data.resize(sizeof(SnapshotHeader) + m_Balls.size() * sizeof(BallSnapshot)
+        + destroyed.size() * sizeof(uint64_t));
+    unsigned char* data = snapshot.m_Data.data();
+
+    SnapshotHeader header;
+    header.State = m_State;
+    header.Level = m_CurrLevel;
+    header.BallCount = static_cast<uint32_t>(m_Balls.size());
+    header.BrickWords = static_cast<uint32_t>(destroyed.size());
+    header.PlayerPosition = m_Player.Position;
+    header.PlayerSize = m_Player.Size;
+    header.PrevPlayerPosition = m_PrevPlayerPosition;
+    PackBits(m_Keys, header.Keys, 1024);
+    PackBits(m_KeysProcessed, header.KeysProcessed, 1024);
+    std::memcpy(data, &header, sizeof(header));
+    data += sizeof(header);
+
+    for (const Ball& ball : m_Balls)
+    {
+        BallSnapshot state = { ball.Position, ball.Velocity, ball.LastPosition, ball.Radius, ball.Stuck };
+        std::memcpy(data, &state, sizeof(state));
+        data += sizeof(state);
+    }
+
+    if (!destroyed.empty())
+        std::memcpy(data, destroyed.data(), destroyed.size() * sizeof(uint64_t));
+}
+
+bool Game::Restore(const GameSnapshot& snapshot)
+{
+    SnapshotHeader header;
+    if (snapshot.Size() < sizeof(header))
+        return false;
+    const unsigned char* data = snapshot.Data();
+    std::memcpy(&header, data, sizeof(header));
+    data += sizeof(header);
+    if (header.State > GAME_END || header.Level >= m_Levels.size()
+        || header.BrickWords != m_Levels[header.Level].Bricks.GetDestroyedWords().size()
+        || snapshot.Size() != sizeof(header) + header.BallCount * sizeof(BallSnapshot)
+            + header.BrickWords * sizeof(uint64_t))
+        return false;
+
+    m_State = static_cast<GameState>(header.State);
+    m_CurrLevel = header.Level;
+    m_Player.Position = header.PlayerPosition;
+    m_Player.Size = header.PlayerSize;
+    m_PrevPlayerPosition = header.PrevPlayerPosition;
+    UnpackBits(header.Keys, m_Keys, 1024);
+    UnpackBits(header.KeysProcessed, m_KeysProcessed, 1024);
+
+    m_Balls.resize(header.BallCount, Ball(glm::vec2(0.0f), BALL_RADIUS, glm::vec2(0.0f), m_BallSprite));
+    for (Ball& ball : m_Balls)
+    {
+        BallSnapshot state;
+        std::memcpy(&state, data, sizeof(state));
+        data += sizeof(state);
+        ball.Position = state.Position;
+        ball.Velocity = state.Velocity;
+        ball.LastPosition = state.LastPosition;
+        ball.Radius = state.Radius;
+        ball.Size = glm::vec2(state.Radius * 2.0f);
+        ball.Stuck = state.Stuck != 0;
     }
-    return (Direction)best_match;
+
+    m_Levels[m_CurrLevel].SetDestroyed(reinterpret_cast<const uint64_t*>(data));
+    return true;
+}
+
+void Game::SetLevelFile(const std::string& file)
+{
+    m_LevelFile = file;
 }
 
-typedef std::tuple<bool, Direction, glm::vec2> Collision;
+unsigned int Game::GetBallCount() const
+{
+    return static_cast<unsigned int>(m_Balls.size());
+}
+
+bool Game::Init(bool headless, const AssetLoader::ProgressFunction& progress)
+{
+#ifdef BREAKOUT_HEADLESS
+    headless = true;
+#endif
+    m_Headless = headless;
+
+    m_Workers = new JobSystem(m_ThreadCount);
+    m_Scratch.resize(m_Workers->Size());
+
+    // decode and parse on the workers first, this thread is only needed for the GL work after
+    AssetLoader loader;
+    Level one;
+    bool loaded = false;
+    loader.Add([this, &one, &loaded]() { loaded = one.Load(m_LevelFile.c_str(), m_Width, m_Height / 2); });
+#ifndef BREAKOUT_HEADLESS
+    TexturePack pack;
+    bool prepacked = !headless && pack.Read(SPRITE_PACK_FILE);
+    if (!headless && !prepacked)
+        pack.QueueBuild(SPRITE_DIRECTORY, loader);
+#endif
+    loader.Run(m_Workers, progress);
+    // Load has already said why
+    if (!loaded)
+        return false;
+
+#ifndef BREAKOUT_HEADLESS
+    if (!headless)
+    {
+        if (!prepacked)
+            pack.FinishBuild();
+        glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(m_Width),
+            static_cast<float>(m_Height), 0.0f, -1.0f, 1.0f);
+        m_Streamer = new TextureStreamer();
+        m_Sprites = new TextureArray(pack, *m_Streamer);
+        m_Renderer = new SpriteRenderer(projection, *m_Sprites);
+        m_Overlay = new Hud(projection);
+        m_BrickSprite = pack.Find("container.jpg");
+        m_PaddleSprite = pack.Find("paddle.png");
+        m_BallSprite = pack.Find("ball.png");
+    }
+#endif
+
+    one.SetBrickSprite(m_BrickSprite);
+    m_Levels.push_back(one);
+    m_CurrLevel = 0;
+
+    glm::vec2 playerPos = glm::vec2(
+        m_Width / 2.0f - PLAYER_SIZE.x / 2.0f,
+        m_Height - PLAYER_SIZE.y
+    );
+    m_Player = Object(playerPos, PLAYER_SIZE, m_PaddleSprite, glm::vec3(1.0f));
+
+    ResetPlayer();
+    return true;
+}
 
 bool CollisionCheck(Object& one, Object& two) // AABB - AABB collision
 {
@@ -105,163 +301,324 @@ bool CollisionCheck(Object& one, Object& two) // AABB - AABB collision
     return collisionX && collisionY;
 }
 
-Collision CollisionCheck(Ball& one, Object& two) // AABB - Circle collision
+// during the parallel phase the level is read-only, so a ball sees the bricks it
+// destroyed itself this step through its own hits at the end of scratch.Hits
+bool BrickLive(const Level& level, unsigned int i, unsigned int ball, const CollisionScratch& scratch)
 {
-    // get center point circle first 
-    glm::vec2 center(one.Position + one.Radius);
-    // calculate AABB info (center, half-extents)
-    glm::vec2 aabb_half_extents(two.Size.x / 2.0f, two.Size.y / 2.0f);
-    glm::vec2 aabb_center(
-        two.Position.x + aabb_half_extents.x,
-        two.Position.y + aabb_half_extents.y
-    );
-    // get difference vector between both centers
-    glm::vec2 difference = center - aabb_center;
-    glm::vec2 clamped = glm::clamp(difference, -aabb_half_extents, aabb_half_extents);
-    // add clamped value to AABB_center and we get the value of box closest to circle
-    glm::vec2 closest = aabb_center + clamped;
-    // retrieve vector between center circle and closest point AABB and check if length <= radius
-    difference = closest - center;
-    if (glm::length(difference) <= one.Radius)
-        return std::make_tuple(true, VectorDirection(difference), difference);
-    else
-        return std::make_tuple(false, UP, glm::vec2(0.0f, 0.0f));
-}
-
-void Game::CheckCollisions()
-{
-    for (Object& box : m_Levels[m_CurrLevel].Bricks)
+    if (level.Bricks.IsDestroyed(i))
+        return false;
+    for (auto hit = scratch.Hits.rbegin(); hit != scratch.Hits.rend() && hit->Ball == ball; ++hit)
+        if (hit->Brick == i)
+            return false;
+    return true;
+}
+
+Playfield Game::GetPlayfield() const
+{
+    return { static_cast<float>(m_Width), &m_Levels[m_CurrLevel], m_Player.Position, m_Player.Size };
+}
+
+void Game::CheckCollisions(Ball& ball, unsigned int id, CollisionScratch& scratch)
+{
+    const Level& level = m_Levels[m_CurrLevel];
+    // destroy bricks once the step's hits are merged
+    CollideBall(ball.Position, ball.Velocity, ball.Radius, ball.LastPosition, ball.Stuck, GetPlayfield(),
+        level.Bricks.GetDestroyedWords().data(), scratch,
+        [&level, id, &scratch](unsigned int i) { return BrickLive(level, i, id, scratch); },
+        [id, &scratch](unsigned int i) { scratch.Hits.push_back({ id, i }); });
+}
+
+void Game::MoveBall(Ball& ball, unsigned int id, float dt, CollisionScratch& scratch)
+{
+    if (ball.Stuck)
+        return;
+
+    const Level& level = m_Levels[m_CurrLevel];
+    SweepBall(ball.Position, ball.Velocity, ball.Radius, dt, GetPlayfield(), scratch,
+        [&level, id, &scratch](unsigned int i) { return BrickLive(level, i, id, scratch); },
+        [id, &scratch](unsigned int i) { scratch.Hits.push_back({ id, i }); });
+}
+
+void Game::Update(float dt)
+{
+    PROFILE_ZONE("Update");
+    for (CollisionScratch& scratch : m_Scratch)
     {
-        if (!box.Destroyed)
+        scratch.Hits.clear();
+        scratch.Tests = 0;
+    }
+
+    // balls only write to themselves and their thread's scratch while the level is
+    // read-only, so they can be stepped on any number of threads
+    m_Workers->ParallelFor(static_cast<unsigned int>(m_Balls.size()), MIN_BALLS_PER_THREAD,
+        [this, dt](unsigned int begin, unsigned int end, unsigned int thread)
         {
-            Collision collision = CollisionCheck(*BallObject, box);
-            if (std::get<0>(collision)) // if collision is true
+            PROFILE_ZONE("MoveBalls");
+            CollisionScratch& scratch = m_Scratch[thread];
+            for (unsigned int i = begin; i < end; ++i)
             {
-                // destroy block if not solid
-                if (!box.IsSolid)
-                    box.Destroyed = true;
-                // collision resolution
-                Direction dir = std::get<1>(collision);
-                glm::vec2 diff_vector = std::get<2>(collision);
-                if (dir == LEFT || dir == RIGHT) // horizontal collision
-                {
-                    BallObject->Velocity.x = -BallObject->Velocity.x; // reverse horizontal velocity
-                    // relocate
-                    float penetration = BallObject->Radius - std::abs(diff_vector.x);
-                    if (dir == LEFT)
-                        BallObject->Position.x += penetration; // move ball to right
-                    else
-                        BallObject->Position.x -= penetration; // move ball to left;
-                }
-                else // vertical collision
-                {
-                    BallObject->Velocity.y = -BallObject->Velocity.y; // reverse vertical velocity
-                    // relocate
-                    float penetration = BallObject->Radius - std::abs(diff_vector.y);
-                    if (dir == UP)
-                        BallObject->Position.y -= penetration; // move ball back up
-                    else
-                        BallObject->Position.y += penetration; // move ball back down
-                }
+                // sweep the ball through the step, then catch anything that was already overlapping
+                MoveBall(m_Balls[i], i, dt, scratch);
+                CheckCollisions(m_Balls[i], i, scratch);
             }
+        });
+
+    // apply the hits in ball order, so the result is the same for any thread count.
+    // A ball's own hits can go in any order, the outcome is the same, so a plain
+    // sort does; stable_sort would allocate a buffer every step
+    PROFILE_ZONE("ApplyHits");
+    m_Hits.clear();
+    for (const CollisionScratch& scratch : m_Scratch)
+    {
+        m_Hits.insert(m_Hits.end(), scratch.Hits.begin(), scratch.Hits.end());
+        m_CollisionTests += scratch.Tests;
+    }
+    std::sort(m_Hits.begin(), m_Hits.end(), [](const BrickHit& a, const BrickHit& b)
+        { return a.Ball != b.Ball ? a.Ball < b.Ball : a.Brick < b.Brick; });
+    Level& level = m_Levels[m_CurrLevel];
+    for (const BrickHit& hit : m_Hits)
+    {
+        if (!level.Bricks.IsDestroyed(hit.Brick))
+        {
+            level.DestroyBrick(hit.Brick);
+            m_BricksDestroyed++;
         }
     }
 
-    Collision result = CollisionCheck(*BallObject, *Player);
-    if (!BallObject->Stuck && std::get<0>(result))
+    // drop the balls that reached the bottom edge, the life is over when none are left
+    unsigned int height = m_Height;
+    m_Balls.erase(std::remove_if(m_Balls.begin(), m_Balls.end(),
+        [height](const Ball& ball) { return ball.Position.y >= height; }), m_Balls.end());
+    if (m_Balls.empty())
     {
-        // check where it hit the board, and change velocity based on where it hit the board
-        float centerBoard = Player->Position.x + Player->Size.x / 2.0f;
-        float distance = (BallObject->Position.x + BallObject->Radius) - centerBoard;
-        float percentage = distance / (Player->Size.x / 2.0f);
-        // then move accordingly
-        float strength = 2.0f;
-        glm::vec2 oldVelocity = BallObject->Velocity;
-        BallObject->Velocity.x = INITIAL_BALL_VELOCITY.x * percentage * strength;
-        //BallObject->Velocity.y = -BallObject->Velocity.y;
-        BallObject->Velocity.y = -1.0f * abs(BallObject->Velocity.y); // THIS ONLY WORKS BECAUSE THE PADDLE IS AT THE BOTTOM
-        BallObject->Velocity = glm::normalize(BallObject->Velocity) * glm::length(oldVelocity);
+        m_LivesLost++;
+        ResetLevel();
+        ResetPlayer();
     }
 }
 
-void Game::Update(float dt)
+void Game::SplitBalls()
 {
-    BallObject->Move(dt, m_Width);
-    CheckCollisions();
-
-    if (BallObject->Position.y >= m_Height) // did ball reach bottom edge?
+    unsigned int count = static_cast<unsigned int>(m_Balls.size());
+    for (unsigned int i = 0; i < count && m_Balls.size() < MAX_BALLS; ++i)
     {
-        ResetLevel();
-        ResetPlayer();
+        if (m_Balls[i].Stuck)
+            continue;
+        Ball split = m_Balls[i];
+        split.Velocity.x = -split.Velocity.x;
+        m_Balls.push_back(split);
     }
 }
 
+void Game::Restart()
+{
+    ResetLevel();
+    ResetPlayer();
+}
+
 void Game::ResetLevel()
 {
-    // TODO: fix this for when we have multiple levels
-    if (m_CurrLevel == 0)
-        m_Levels[0].Load("res/levels/lvl1.txt", m_Width, m_Height / 2);
+    // levels are parsed once in Init and kept; resetting only brings the bricks back
+    m_Levels[m_CurrLevel].Reset();
 }
 
 void Game::ResetPlayer()
 {
     // reset player/ball stats
-    Player->Size = PLAYER_SIZE;
-    Player->Position = glm::vec2(m_Width / 2.0f - PLAYER_SIZE.x / 2.0f, m_Height - PLAYER_SIZE.y);
-    BallObject->Reset(Player->Position + glm::vec2(PLAYER_SIZE.x / 2.0f - BALL_RADIUS, -(BALL_RADIUS * 2.0f)), INITIAL_BALL_VELOCITY);
+    m_Player.Size = PLAYER_SIZE;
+    m_Player.Position = glm::vec2(m_Width / 2.0f - PLAYER_SIZE.x / 2.0f, m_Height - PLAYER_SIZE.y);
+    // every ball of a new life starts on the paddle, spread evenly across it so
+    // they come off it at different angles
+    m_Balls.clear();
+    m_Balls.reserve(m_BallCount);
+    for (unsigned int i = 0; i < m_BallCount; ++i)
+    {
+        glm::vec2 ballPos = m_Player.Position + glm::vec2(PLAYER_SIZE.x * (i + 0.5f) / m_BallCount - BALL_RADIUS,
+            -(BALL_RADIUS * 2.0f));
+        m_Balls.push_back(Ball(ballPos, BALL_RADIUS, INITIAL_BALL_VELOCITY, m_BallSprite));
+    }
+    // don't interpolate across the teleport
+    m_PrevPlayerPosition = m_Player.Position;
 }
 
 void Game::ProcessInput(float dt)
 {
+    PROFILE_ZONE("ProcessInput");
     if (m_State == GAME_ACTIVE)
     {
         float velocity = PLAYER_VELOCITY * dt;
         if (m_Keys[GLFW_KEY_A] || m_Keys[GLFW_KEY_LEFT])
         {
-            if (Player->Position.x >= 0.0f)
+            if (m_Player.Position.x >= 0.0f)
             {
-                Player->Position.x -= velocity;
-                if (BallObject->Stuck)
+                m_Player.Position.x -= velocity;
+                for (Ball& ball : m_Balls)
                 {
-                    BallObject->Position.x -= velocity;
+                    if (ball.Stuck)
+                        ball.Position.x -= velocity;
                 }
             }
         }
         if (m_Keys[GLFW_KEY_D] || m_Keys[GLFW_KEY_RIGHT])
         {
-            if (Player->Position.x + Player->Size.x <= m_Width)
+            if (m_Player.Position.x + m_Player.Size.x <= m_Width)
             {
-                Player->Position.x += velocity;
-                if (BallObject->Stuck)
+                m_Player.Position.x += velocity;
+                for (Ball& ball : m_Balls)
                 {
-                    BallObject->Position.x += velocity;
+                    if (ball.Stuck)
+                        ball.Position.x += velocity;
                 }
             }
         }
         if (m_Keys[GLFW_KEY_SPACE])
         {
-            BallObject->Stuck = false;
+            for (Ball& ball : m_Balls)
+                ball.Stuck = false;
+        }
+        // multi-ball: split every ball in flight
+        if (m_Keys[GLFW_KEY_M] && !m_KeysProcessed[GLFW_KEY_M])
+        {
+            SplitBalls();
+            m_KeysProcessed[GLFW_KEY_M] = true;
         }
         if (m_Keys[GLFW_KEY_R])
         {
             ResetLevel();
             ResetPlayer();
         }
+        // toggle between batched and per-sprite drawing to compare draw calls
+        if (m_Keys[GLFW_KEY_B] && !m_KeysProcessed[GLFW_KEY_B])
+        {
+            m_Batching = !m_Batching;
+            m_KeysProcessed[GLFW_KEY_B] = true;
+        }
+        // dump the profiler's recent history for chrome://tracing
+        if (m_Keys[GLFW_KEY_P] && !m_KeysProcessed[GLFW_KEY_P])
+        {
+            if (Profiler::WriteChromeTrace(TRACE_FILE))
+                std::cout << "Wrote " << TRACE_FILE << std::endl;
+            m_KeysProcessed[GLFW_KEY_P] = true;
+        }
+#ifndef BREAKOUT_HEADLESS
+        // time the level, paddle and ball passes on the GPU
+        if (m_Keys[GLFW_KEY_G] && !m_KeysProcessed[GLFW_KEY_G])
+        {
+            SetGpuTiming(!m_GpuTiming);
+            m_KeysProcessed[GLFW_KEY_G] = true;
+        }
+        // performance overlay
+        if (m_Keys[GLFW_KEY_H] && !m_KeysProcessed[GLFW_KEY_H])
+        {
+            m_ShowHud = !m_ShowHud;
+            m_KeysProcessed[GLFW_KEY_H] = true;
+        }
+#endif
     }
 }
 
-void Game::Render(float time)
+void Game::Step(float dt)
 {
+    PROFILE_ZONE("Step");
+    // LastPosition doubles as the interpolation start and the broadphase sweep start
+    m_PrevPlayerPosition = m_Player.Position;
+    for (Ball& ball : m_Balls)
+        ball.LastPosition = ball.Position;
+    ProcessInput(dt);
+    Update(dt);
+    if (m_Recording)
+        m_Recording->EndTick(StateHash());
+}
+
+void Game::Render(float alpha)
+{
+#ifndef BREAKOUT_HEADLESS
+    if (m_Headless)
+        return;
+
+    PROFILE_ZONE("Render");
+    m_Overlay->AddFrame();
+    m_Renderer->ResetStats();
+    m_Streamer->Poll();
     if (m_State == GAME_ACTIVE)
     {
         //std::cout << "active" << std::endl;
-        m_Levels[m_CurrLevel].Draw(*Renderer);
-        Player->Draw(*Renderer);
-        BallObject->Draw(*Renderer);
+        // timed passes flush the batch at their end so each is its own draw;
+        // untimed, the paddle and the balls share one
+        GpuTimer* timer = m_GpuTiming ? m_PassTimer : nullptr;
+        if (timer)
+            timer->BeginFrame();
+        if (m_Batching)
+            m_Renderer->BeginBatch();
+        {
+            GpuPass pass(timer, "Level");
+            m_Levels[m_CurrLevel].Draw(*m_Renderer);
+        }
+        {
+            GpuPass pass(timer, "Paddle");
+            m_Player.DrawAt(*m_Renderer, glm::mix(m_PrevPlayerPosition, m_Player.Position, alpha));
+            if (timer && m_Batching)
+                m_Renderer->Flush();
+        }
+        {
+            GpuPass pass(timer, "Balls");
+            for (Ball& ball : m_Balls)
+                ball.DrawAt(*m_Renderer, glm::mix(ball.LastPosition, ball.Position, alpha));
+            if (m_Batching)
+                m_Renderer->EndBatch();
+        }
     }
+
+    // drawn last so it is on top; its own draw isn't counted in what it reports
+    if (m_ShowHud)
+        m_Overlay->Draw({ m_Renderer->GetStats(), m_CollisionTests, m_Sprites->GetResidency() },
+            GetGpuTimings());
+    m_CollisionTests = 0;
+#else
+    (void)alpha; // headless builds never draw
+#endif
 }
 
 void Game::SetKey(int key, bool val)
 {
+    if (key < 0 || key >= 1024)
+        return;
+    if (m_Recording)
+        m_Recording->AddKey(key, val);
     m_Keys[key] = val;
-}
\ No newline at end of file
+    if (!val)
+        m_KeysProcessed[key] = false;
+}
+
+#ifndef BREAKOUT_HEADLESS
+const RenderStats& Game::GetRenderStats() const
+{
+    return m_Renderer->GetStats();
+}
+
+TextureResidency Game::GetTextureResidency() const
+{
+    return m_Sprites->GetResidency();
+}
+
+void Game::SetGpuTiming(bool enabled)
+{
+    if (m_Headless || enabled == m_GpuTiming)
+        return;
+
+    if (enabled)
+    {
+        if (!m_PassTimer)
+            m_PassTimer = new GpuTimer();
+        // results from before timing was switched off would be stale
+        m_PassTimer->Reset();
+    }
+    m_GpuTiming = enabled;
+}
+
+const std::vector<GpuTiming>& Game::GetGpuTimings() const
+{
+    static const std::vector<GpuTiming> none;
+    return m_GpuTiming ? m_PassTimer->GetTimings() : none;
+}
+#endif
\ No newline at end of file
@@ -1,6 +1,17 @@
 #pragma once
 
+#include <cstdint>
+#include <string>
+
 #include "Level.h"
+#include "Ball.h"
+#include "BallPhysics.h"
+#include "AssetLoader.h"
+#include "JobSystem.h"
+#include "InputRecording.h"
+#ifndef BREAKOUT_HEADLESS
+#include "GpuTimer.h"
+#endif
 
 enum GameState {
     GAME_ACTIVE,
@@ -8,24 +19,146 @@ enum GameState {
     GAME_END
 };
 
+// a brick hit by a ball during the parallel collision phase
+struct BrickHit
+{
+    unsigned int Ball;
+    unsigned int Brick;
+};
+
+// per-thread scratch for the parallel collision phase
+struct CollisionScratch : public BallScratch
+{
+    std::vector<BrickHit> Hits;
+};
+
+class SpriteRenderer;
+class TextureStreamer;
+class TextureArray;
+struct TextureResidency;
+class GpuTimer;
+class Hud;
+
+// The simulation state of a Game in one flat buffer of plain data, with no
+// pointers into the game, so taking and restoring one is a handful of copies.
+// The buffer is reused, so saving into the same snapshot again doesn't allocate
+// unless there are more balls than before. The game has no random number
+// generator; the state is the paddle, the balls, the bricks and the keys.
+class GameSnapshot
+{
+private:
+    std::vector<unsigned char> m_Data;
+
+    friend class Game;
+public:
+    inline const unsigned char* Data() const { return m_Data.data(); }
+    inline size_t Size() const { return m_Data.size(); }
+};
+
 class Game
 {
 private:
     GameState               m_State;
     unsigned int            m_Width, m_Height;
     bool                    m_Keys[1024];
+    bool                    m_KeysProcessed[1024];
     std::vector<Level>      m_Levels;
     unsigned int            m_CurrLevel;
+    bool                    m_Batching;
+    bool                    m_Headless;
+    bool                    m_GpuTiming;
+    bool                    m_ShowHud;
+    // collision tests since the last frame was drawn
+    uint64_t                m_CollisionTests;
+    // running totals since Init, not part of the simulation state
+    uint64_t                m_BricksDestroyed;
+    uint64_t                m_LivesLost;
+    // paddle position at the start of the current step, for render interpolation
+    glm::vec2               m_PrevPlayerPosition;
+    // how many balls each life starts with
+    unsigned int            m_BallCount;
+    std::string             m_LevelFile;
+    // every SetKey and the state after every Step go here when set
+    InputRecording*         m_Recording;
+
+    // balls collide in parallel against the brick state from the start of the
+    // step; their hits are merged and applied in ball order afterwards
+    unsigned int                  m_ThreadCount;
+    JobSystem*                    m_Workers;
+    std::vector<CollisionScratch> m_Scratch;
+    std::vector<BrickHit>         m_Hits;
+
+    Object                  m_Player;
+    std::vector<Ball>       m_Balls;
+
+    // rendering resources, left null (or 0) when running headless
+    SpriteRenderer*         m_Renderer;
+    TextureStreamer*        m_Streamer;
+    TextureArray*           m_Sprites;
+    GpuTimer*               m_PassTimer;
+    Hud*                    m_Overlay;
+    unsigned int            m_BrickSprite;
+    unsigned int            m_PaddleSprite;
+    unsigned int            m_BallSprite;
 
     void ResetLevel();
     void ResetPlayer();
-    void CheckCollisions();
+    // the walls, level and paddle the balls collide with this step
+    Playfield GetPlayfield() const;
+    void CheckCollisions(Ball& ball, unsigned int id, CollisionScratch& scratch);
+    // advances a ball through the step with continuous collision against
+    // walls, bricks and the paddle, resolving impacts in time order
+    void MoveBall(Ball& ball, unsigned int id, float dt, CollisionScratch& scratch);
+    // splits every ball in two, mirrored horizontally
+    void SplitBalls();
 public:
     Game(unsigned int width, unsigned int height);
     ~Game();
-    void Init();
+    // both must be set before Init
+    void SetBallCount(unsigned int count);
+    void SetThreadCount(unsigned int threads);
+    // a .txt or .lvl file, res/levels/lvl1.txt by default
+    void SetLevelFile(const std::string& file);
+    inline const std::string& GetLevelFile() const { return m_LevelFile; }
+    // headless runs the simulation without creating any GL objects; builds
+    // with BREAKOUT_HEADLESS defined are always headless. Images and levels are
+    // loaded on the worker threads, progress is called on this thread as they finish.
+    // Returns false if the level could not be loaded; the game can't be played then
+    bool Init(bool headless = false, const AssetLoader::ProgressFunction& progress = nullptr);
     void ProcessInput(float dt);
     void Update(float dt);
-    void Render(float time);
+    // one fixed simulation step: input then update
+    void Step(float dt);
+    // alpha is how far the frame is between the previous and the current step, in [0, 1]
+    void Render(float alpha);
     void SetKey(int key, bool val);
+    // records from here on; the recording must outlive the game or be unset.
+    // Hz is left for the caller, who owns the step rate
+    void SetRecording(InputRecording* recording);
+    // hash of everything the simulation carries from one step to the next
+    uint32_t StateHash() const;
+    // snapshots only restore into a game running the same level; Restore
+    // returns false and changes nothing for any other
+    void Save(GameSnapshot& snapshot) const;
+    bool Restore(const GameSnapshot& snapshot);
+    inline unsigned int GetWidth() const { return m_Width; }
+    inline unsigned int GetHeight() const { return m_Height; }
+    inline const Level& GetCurrentLevel() const { return m_Levels[m_CurrLevel]; }
+    unsigned int GetBallCount() const;
+    inline const Object& GetPlayer() const { return m_Player; }
+    inline const std::vector<Ball>& GetBalls() const { return m_Balls; }
+    inline uint64_t GetBricksDestroyed() const { return m_BricksDestroyed; }
+    // a life is lost when the last ball leaves the bottom; the level resets with it
+    inline uint64_t GetLivesLost() const { return m_LivesLost; }
+    // brings the bricks back and starts a new life without counting a lost one;
+    // the game itself never ends a level, this is for whoever drives it
+    void Restart();
+#ifndef BREAKOUT_HEADLESS
+    const RenderStats& GetRenderStats() const;
+    TextureResidency GetTextureResidency() const;
+    // GPU times of the level, paddle and ball passes, a few frames behind;
+    // toggled with G, off by default
+    void SetGpuTiming(bool enabled);
+    const std::vector<GpuTiming>& GetGpuTimings() const;
+#endif
 };
@@ -0,0 +1,98 @@
+#include "GpuTimer.h"
+
+#include "Profiler.h"
+
+// the GPU and CPU clocks drift apart slowly, so the mapping is redone now and then
+const unsigned int CALIBRATION_INTERVAL = 256;
+
+GpuTimer::GpuTimer()
+    : m_Frames(), m_Current(0), m_Open(MAX_PASSES), m_ClockOffset(0), m_FramesSinceCalibration(0)
+{
+    for (Frame& frame : m_Frames)
+        glGenQueries(MAX_PASSES * 2, frame.Queries);
+    Calibrate();
+}
+
+GpuTimer::~GpuTimer()
+{
+    for (Frame& frame : m_Frames)
+        glDeleteQueries(MAX_PASSES * 2, frame.Queries);
+}
+
+void GpuTimer::Calibrate()
+{
+    GLint64 gpuNow = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+    m_ClockOffset = static_cast<int64_t>(Profiler::Now()) - gpuNow;
+    m_FramesSinceCalibration = 0;
+}
+
+void GpuTimer::Resolve(Frame& frame)
+{
+    if (frame.Count == 0)
+        return;
+
+    // timestamps land in order, so the last one being there means they all are
+    GLint available = 0;
+    glGetQueryObjectiv(frame.Queries[frame.Count * 2 - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+    {
+        // the GPU is more than FRAME_LATENCY frames behind; drop the frame rather than wait
+        frame.Count = 0;
+        return;
+    }
+
+    m_Timings.clear();
+    for (unsigned int i = 0; i < frame.Count; ++i)
+    {
+        GLuint64 start = 0, end = 0;
+        glGetQueryObjectui64v(frame.Queries[i * 2], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(frame.Queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+        m_Timings.push_back({ frame.Names[i], (end - start) / 1000000.0f });
+        Profiler::RecordGpu(frame.Names[i], start + m_ClockOffset, end + m_ClockOffset);
+    }
+    frame.Count = 0;
+}
+
+void GpuTimer::BeginFrame()
+{
+    if (m_Open != MAX_PASSES)
+        EndPass();
+
+    m_Current = (m_Current + 1) % FRAME_LATENCY;
+    Resolve(m_Frames[m_Current]);
+
+    if (++m_FramesSinceCalibration >= CALIBRATION_INTERVAL)
+        Calibrate();
+}
+
+void GpuTimer::BeginPass(const char* name)
+{
+    Frame& frame = m_Frames[m_Current];
+    if (m_Open != MAX_PASSES || frame.Count == MAX_PASSES)
+        return;
+
+    m_Open = frame.Count;
+    frame.Names[m_Open] = name;
+    glQueryCounter(frame.Queries[m_Open * 2], GL_TIMESTAMP);
+}
+
+void GpuTimer::EndPass()
+{
+    if (m_Open == MAX_PASSES)
+        return;
+
+    Frame& frame = m_Frames[m_Current];
+    glQueryCounter(frame.Queries[m_Open * 2 + 1], GL_TIMESTAMP);
+    frame.Count++;
+    m_Open = MAX_PASSES;
+}
+
+void GpuTimer::Reset()
+{
+    for (Frame& frame : m_Frames)
+        frame.Count = 0;
+    m_Open = MAX_PASSES;
+    m_Timings.clear();
+    Calibrate();
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <GL/glew.h>
+
+// a pass's GPU time from the most recently resolved frame
+struct GpuTiming
+{
+    const char* Name;
+    float       Milliseconds;
+};
+
+// Times render passes on the GPU with GL_TIMESTAMP query pairs. Queries are
+// kept in a ring of FRAME_LATENCY frames: a frame's results are only read when
+// its slot comes round again, and only if the driver says they are available,
+// so reading them never stalls the pipeline. Resolved passes are recorded on
+// the profiler's GPU track, mapped onto its clock, next to the CPU zones.
+class GpuTimer
+{
+public:
+    static const unsigned int FRAME_LATENCY = 4;
+    static const unsigned int MAX_PASSES = 16;
+private:
+    struct Frame
+    {
+        // a start and an end timestamp per pass
+        unsigned int Queries[MAX_PASSES * 2];
+        const char*  Names[MAX_PASSES];
+        unsigned int Count;
+    };
+
+    Frame                  m_Frames[FRAME_LATENCY];
+    unsigned int           m_Current;
+    // pass open in the current frame, MAX_PASSES if none
+    unsigned int           m_Open;
+    // Profiler::Now() minus the GPU timestamp at the same moment
+    int64_t                m_ClockOffset;
+    unsigned int           m_FramesSinceCalibration;
+    std::vector<GpuTiming> m_Timings;
+
+    void Calibrate();
+    // reads back the frame in the current slot if its queries have landed
+    void Resolve(Frame& frame);
+public:
+    GpuTimer();
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    // moves to the next slot of the ring, resolving the frame that used it
+    void BeginFrame();
+    // passes don't nest; name must outlive the timer
+    void BeginPass(const char* name);
+    void EndPass();
+    // forgets queries in flight, e.g. after timing was switched off for a while
+    void Reset();
+
+    inline const std::vector<GpuTiming>& GetTimings() const { return m_Timings; }
+};
+
+class GpuPass
+{
+private:
+    GpuTimer* m_Timer;
+public:
+    // a null timer times nothing
+    GpuPass(GpuTimer* timer, const char* name) : m_Timer(timer) { if (m_Timer) m_Timer->BeginPass(name); }
+    ~GpuPass() { if (m_Timer) m_Timer->EndPass(); }
+
+    GpuPass(const GpuPass&) = delete;
+    GpuPass& operator=(const GpuPass&) = delete;
+};
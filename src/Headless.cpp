@@ -0,0 +1,302 @@
+#include "Headless.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "AllocationCounter.h"
+#include "InputRecording.h"
+#include "BatchEnv.h"
+#include "JobSystem.h"
+
+int RunHeadless(Game& game, unsigned int ticks, float dt)
+{
+    if (!game.Init(true))
+        return 1;
+    game.SetKey(GLFW_KEY_SPACE, true);
+
+    uint64_t allocations = AllocationCounter::GetCount();
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < ticks; ++i)
+    {
+        game.Step(dt);
+    }
+    auto end = std::chrono::steady_clock::now();
+    allocations = AllocationCounter::GetCount() - allocations;
+
+    double wallSeconds = std::chrono::duration<double>(end - start).count();
+    double simSeconds = ticks * static_cast<double>(dt);
+    const BrickSet& bricks = game.GetCurrentLevel().Bricks;
+    std::cout << "Headless: " << ticks << " ticks, " << simSeconds << "s simulated in "
+        << wallSeconds << "s (" << (wallSeconds > 0.0 ? simSeconds / wallSeconds : 0.0)
+        << "x real time), " << bricks.DestroyedCount() << "/" << bricks.Size()
+        << " bricks destroyed, " << game.GetBallCount() << " balls left" << std::endl;
+    if (AllocationCounter::IsEnabled())
+        std::cout << "Allocations: " << allocations << " in " << ticks << " ticks ("
+            << (ticks ? allocations / static_cast<double>(ticks) : 0.0) << " per tick)" << std::endl;
+    return 0;
+}
+
+int RunReplay(Game& game, const char* path, unsigned int snapshotTick)
+{
+    InputRecording recording;
+    if (!recording.Read(path))
+        return 1;
+    if (recording.Width != game.GetWidth() || recording.Height != game.GetHeight())
+    {
+        std::cout << "RECORDING IS FOR A " << recording.Width << "x" << recording.Height
+            << " GAME: " << path << std::endl;
+        return 1;
+    }
+
+    game.SetBallCount(recording.BallCount);
+    game.SetLevelFile(recording.LevelFile);
+    if (!game.Init(true))
+        return 1;
+
+    // only the steps are timed, the hash check is not part of the simulation
+    float dt = 1.0f / recording.Hz;
+    double wallSeconds = 0.0;
+    GameSnapshot snapshot;
+    double saveSeconds = 0.0;
+    auto play = [&](unsigned int from, unsigned int to)
+    {
+        size_t next = std::lower_bound(recording.Events.begin(), recording.Events.end(), from,
+            [](const KeyEvent& event, unsigned int tick) { return event.Tick < tick; })
+            - recording.Events.begin();
+        for (unsigned int tick = from; tick < to; ++tick)
+        {
+            if (tick == snapshotTick && from == 0)
+            {
+                auto saveStart = std::chrono::steady_clock::now();
+                game.Save(snapshot);
+                saveSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - saveStart).count();
+            }
+
+            for (; next < recording.Events.size() && recording.Events[next].Tick == tick; ++next)
+                game.SetKey(recording.Events[next].Key, recording.Events[next].Down);
+
+            auto start = std::chrono::steady_clock::now();
+            game.Step(dt);
+            wallSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            if (game.StateHash() != recording.Hashes[tick])
+            {
+                std::cout << "REPLAY DIVERGED AT TICK " << tick << " OF " << recording.TickCount()
+                    << (from > 0 ? " AFTER RESTORING: " : ": ") << path << std::endl;
+                return false;
+            }
+        }
+        return true;
+    };
+
+    if (!play(0, recording.TickCount()))
+        return 1;
+
+    double simSeconds = recording.TickCount() / static_cast<double>(recording.Hz);
+    std::cout << "Replay: " << recording.TickCount() << " ticks, " << recording.Events.size()
+        << " key events, " << simSeconds << "s simulated in " << wallSeconds << "s ("
+        << (wallSeconds > 0.0 ? simSeconds / wallSeconds : 0.0) << "x real time), every tick matches"
+        << std::endl;
+
+    if (snapshotTick >= recording.TickCount())
+        return 0;
+
+    auto restoreStart = std::chrono::steady_clock::now();
+    bool restored = game.Restore(snapshot);
+    double restoreSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - restoreStart).count();
+    if (!restored)
+    {
+        std::cout << "SNAPSHOT FAILED TO RESTORE: " << path << std::endl;
+        return 1;
+    }
+    if (!play(snapshotTick, recording.TickCount()))
+        return 1;
+
+    std::cout << "Snapshot: " << snapshot.Size() << " bytes at tick " << snapshotTick << " with "
+        << recording.BallCount << " balls, saved in " << saveSeconds * 1e6 << "us, restored in "
+        << restoreSeconds * 1e6 << "us, ticks " << snapshotTick << "-" << recording.TickCount() - 1
+        << " match again" << std::endl;
+    return 0;
+}
+
+int RunBatchBenchmark(unsigned int games, unsigned int steps, unsigned int threads, float dt,
+    const std::string& levelFile)
+{
+    auto loadStart = std::chrono::steady_clock::now();
+    BatchEnv env(games, threads, dt, levelFile);
+    if (!env.IsLoaded())
+        return 1;
+    double loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loadStart).count();
+
+    // an action is held for a few steps at a time, closer to what a player does
+    // than a new one every tick
+    const unsigned int ACTION_REPEAT = 8;
+    std::vector<uint8_t> actions(games);
+    unsigned int seed = 1;
+    double reward = 0.0;
+    uint64_t episodes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int step = 0; step < steps; ++step)
+    {
+        if (step % ACTION_REPEAT == 0)
+        {
+            for (uint8_t& action : actions)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                action = static_cast<uint8_t>((seed >> 24) % 4);
+            }
+        }
+        env.Step(actions.data());
+        for (unsigned int i = 0; i < games; ++i)
+        {
+            reward += env.Rewards()[i];
+            episodes += env.Dones()[i];
+        }
+    }
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double gameSteps = static_cast<double>(games) * steps;
+    std::cout << "Batch: " << games << " games x " << steps << " steps on " << threads << " threads in "
+        << wallSeconds << "s, " << (wallSeconds > 0.0 ? gameSteps / wallSeconds : 0.0)
+        << " game steps/s (loaded in " << loadSeconds << "s), " << episodes << " episodes ended, "
+        << reward << " total reward" << std::endl;
+    return 0;
+}
+
+int RunJobBenchmark(unsigned int threads)
+{
+    const unsigned int SPAWN_JOBS = 1 << 18;
+    const unsigned int CHAIN_JOBS = 1 << 14;
+    const unsigned int KERNEL_ITEMS = 1 << 22;
+    const unsigned int KERNEL_ROUNDS = 64;
+
+    // an integer hash mixed a few rounds per item, enough that scaling isn't memory bound
+    auto kernel = [](unsigned int item)
+    {
+        uint32_t x = item;
+        for (unsigned int round = 0; round < KERNEL_ROUNDS; ++round)
+            x = (x ^ (x >> 15)) * 0x2C1B3C6Du + round;
+        return x;
+    };
+
+    double serialSeconds = 0.0;
+    for (unsigned int count = 1; count <= threads; count = count < threads ? std::min(count * 2, threads) : count + 1)
+    {
+        JobSystem jobs(count);
+
+        // spawn overhead: many empty jobs from one thread, workers stealing them
+        JobCounter spawned;
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < SPAWN_JOBS; ++i)
+            jobs.Schedule([]() { }, &spawned);
+        jobs.Wait(spawned);
+        double spawnSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // dependencies: each job may only start once the one before it is done
+        std::vector<std::unique_ptr<JobCounter>> chain;
+        for (unsigned int i = 0; i < CHAIN_JOBS; ++i)
+            chain.emplace_back(new JobCounter());
+        start = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < CHAIN_JOBS; ++i)
+            jobs.Schedule([]() { }, chain[i].get(), i > 0 ? chain[i - 1].get() : nullptr);
+        jobs.Wait(*chain.back());
+        double chainSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // scalability: the same work split over the threads
+        std::vector<uint32_t> sums(count, 0);
+        start = std::chrono::steady_clock::now();
+        jobs.ParallelFor(KERNEL_ITEMS, 1024, [&](unsigned int begin, unsigned int end, unsigned int thread)
+            {
+                uint32_t sum = 0;
+                for (unsigned int i = begin; i < end; ++i)
+                    sum += kernel(i);
+                sums[thread] += sum;
+            });
+        double kernelSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (count == 1)
+            serialSeconds = kernelSeconds;
+        uint32_t checksum = 0;
+        for (uint32_t sum : sums)
+            checksum += sum;
+
+        std::cout << "Jobs: " << count << " threads, " << spawnSeconds * 1e9 / SPAWN_JOBS << " ns per job, "
+            << chainSeconds * 1e9 / CHAIN_JOBS << " ns per dependent job, parallel for " << kernelSeconds * 1e3
+            << " ms (" << (kernelSeconds > 0.0 ? serialSeconds / kernelSeconds : 0.0) << "x, checksum "
+            << checksum << ")" << std::endl;
+    }
+    return 0;
+}
+
+int RunLevelBenchmark(const std::vector<std::string>& files)
+{
+    const unsigned int GENERATED_LEVELS = 16;
+    const unsigned int GENERATED_SIZE = 1024;
+    const unsigned int RUNS = 5;
+
+    std::vector<std::string> corpus;
+    for (const std::string& file : files)
+    {
+        std::ifstream in(file, std::ios::binary);
+        std::ostringstream text;
+        text << in.rdbuf();
+        corpus.push_back(text.str());
+    }
+    if (corpus.empty())
+    {
+        // fixed seed so every run parses the same corpus
+        unsigned int seed = 1;
+        for (unsigned int level = 0; level < GENERATED_LEVELS; ++level)
+        {
+            std::string text;
+            for (unsigned int y = 0; y < GENERATED_SIZE; ++y)
+            {
+                for (unsigned int x = 0; x < GENERATED_SIZE; ++x)
+                {
+                    seed = seed * 1664525u + 1013904223u;
+                    text += static_cast<char>('0' + (seed >> 24) % 6);
+                    text += x + 1 < GENERATED_SIZE ? ' ' : '\n';
+                }
+            }
+            corpus.push_back(text);
+        }
+    }
+
+    size_t bytes = 0;
+    for (const std::string& text : corpus)
+        bytes += text.size();
+
+    std::vector<unsigned char> tiles;
+    std::string error;
+    double best = 0.0;
+    size_t tileCount = 0;
+    for (unsigned int run = 0; run < RUNS; ++run)
+    {
+        tileCount = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < corpus.size(); ++i)
+        {
+            unsigned int width, height;
+            if (!ParseTextLevel(corpus[i].data(), corpus[i].size(), tiles, width, height, error))
+            {
+                std::cout << "LEVEL FAILED TO PARSE: " << (i < files.size() ? files[i] : "generated") << ": " << error << std::endl;
+                return 1;
+            }
+            tileCount += tiles.size();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (run == 0 || seconds < best)
+            best = seconds;
+    }
+
+    std::cout << "Level parse: " << corpus.size() << " levels, " << bytes / (1024.0 * 1024.0) << " MiB, "
+        << tileCount << " tiles, best of " << RUNS << ": " << best << "s ("
+        << bytes / (1024.0 * 1024.0) / best << " MiB/s, " << tileCount / 1e6 / best << "M tiles/s)" << std::endl;
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Game.h"
+
+// Steps the game for a fixed number of ticks without a window or GL context,
+// as fast as the CPU allows, and reports how much faster than real time that was.
+// The launch key is held down so the ball is relaunched after every reset.
+int RunHeadless(Game& game, unsigned int ticks, float dt);
+
+// Plays a recording made with --record back headless, as fast as the CPU
+// allows, checking the state after every tick against the recorded hash.
+// The game must not be initialised yet; it takes its ball count and level
+// from the recording. Fails at the first tick that diverges.
+//
+// With a snapshotTick inside the recording, the state is also saved before
+// that tick, the replay runs on to the end, and then the state is restored
+// and the rest of the recording is played and checked a second time. The
+// save and restore times are reported.
+const unsigned int NO_SNAPSHOT = ~0u;
+int RunReplay(Game& game, const char* path, unsigned int snapshotTick = NO_SNAPSHOT);
+
+// Steps games independent headless games in lockstep with BatchEnv for steps
+// steps, with random actions from a fixed seed, and reports game steps per second.
+int RunBatchBenchmark(unsigned int games, unsigned int steps, unsigned int threads, float dt,
+    const std::string& levelFile);
+
+// Microbenchmarks for JobSystem: the cost of scheduling and running empty jobs,
+// a chain of dependent jobs, and the speedup of a ParallelFor over a fixed
+// amount of work at every thread count from 1 up to threads.
+int RunJobBenchmark(unsigned int threads);
+
+// Times ParseTextLevel over the given text levels, read into memory first so
+// only parsing is measured. With no files it generates a corpus of large
+// random levels.
+int RunLevelBenchmark(const std::vector<std::string>& files);
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "Hud.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "Profiler.h"
+
+const glm::vec2 HUD_POSITION(8.0f, 8.0f);
+const float HUD_TEXT_SCALE = 2.0f;
+const float HUD_LINE_HEIGHT = (TextRenderer::GLYPH_HEIGHT + 2) * HUD_TEXT_SCALE;
+const float HUD_PADDING = 6.0f;
+
+// the graph is one pixel per frame; bars are clamped at GRAPH_MAX_MS
+const float GRAPH_HEIGHT = 60.0f;
+const float GRAPH_MAX_MS = 50.0f;
+// a frame longer than this missed 60 Hz, one longer than twice it missed 30 Hz
+const float TARGET_FRAME_MS = 1000.0f / 60.0f;
+
+const glm::vec4 BACKGROUND_COLOR(0.0f, 0.0f, 0.0f, 0.6f);
+const glm::vec4 TEXT_COLOR(1.0f, 1.0f, 1.0f, 1.0f);
+const glm::vec4 GOOD_COLOR(0.2f, 0.9f, 0.3f, 1.0f);
+const glm::vec4 SLOW_COLOR(1.0f, 0.8f, 0.1f, 1.0f);
+const glm::vec4 BAD_COLOR(1.0f, 0.2f, 0.2f, 1.0f);
+const glm::vec4 TARGET_LINE_COLOR(1.0f, 1.0f, 1.0f, 0.35f);
+
+Hud::Hud(const glm::mat4& projection)
+    : m_Text(projection), m_FrameTimes(), m_Next(0), m_Count(0), m_LastFrame(0)
+{
+    m_Sorted.reserve(HISTORY);
+}
+
+void Hud::AddFrame()
+{
+    uint64_t now = Profiler::Now();
+    if (m_LastFrame != 0)
+    {
+        m_FrameTimes[m_Next] = (now - m_LastFrame) / 1000000.0f;
+        m_Next = (m_Next + 1) % HISTORY;
+        m_Count = std::min(m_Count + 1, HISTORY);
+    }
+    m_LastFrame = now;
+}
+
+void Hud::Draw(const HudFrameStats& stats, const std::vector<GpuTiming>& gpu)
+{
+    if (m_Count == 0)
+        return;
+
+    // percentiles by rank over the history; a partial sort of 240 floats is nothing next to a frame
+    m_Sorted.assign(m_FrameTimes, m_FrameTimes + m_Count);
+    auto percentile = [this](float p)
+    {
+        size_t rank = std::min(static_cast<size_t>(p * m_Sorted.size()), m_Sorted.size() - 1);
+        std::nth_element(m_Sorted.begin(), m_Sorted.begin() + rank, m_Sorted.end());
+        return m_Sorted[rank];
+    };
+    float p50 = percentile(0.50f);
+    float p99 = percentile(0.99f);
+    float max = *std::max_element(m_Sorted.begin(), m_Sorted.end());
+    float mean = 0.0f;
+    for (float time : m_Sorted)
+        mean += time;
+    mean /= m_Sorted.size();
+
+    unsigned int lines = 0;
+    std::snprintf(m_Lines[lines++], LINE_LENGTH, "FPS %.0f  FRAME %.2f MS", 1000.0f / mean, mean);
+    std::snprintf(m_Lines[lines++], LINE_LENGTH, "P50 %.2f  P99 %.2f  MAX %.2f", p50, p99, max);
+    std::snprintf(m_Lines[lines++], LINE_LENGTH, "DRAWS %u  SPRITES %u", stats.Render.DrawCalls, stats.Render.Sprites);
+    std::snprintf(m_Lines[lines++], LINE_LENGTH, "COLLISION TESTS %llu",
+        static_cast<unsigned long long>(stats.CollisionTests));
+    std::snprintf(m_Lines[lines++], LINE_LENGTH, "TEXTURES %u LAYERS %.1f MIB", stats.Textures.Layers,
+        stats.Textures.Bytes / (1024.0 * 1024.0));
+    for (size_t i = 0; i < gpu.size() && lines < MAX_LINES; ++i)
+        std::snprintf(m_Lines[lines++], LINE_LENGTH, "GPU %s %.3f MS", gpu[i].Name, gpu[i].Milliseconds);
+
+    float width = static_cast<float>(HISTORY);
+    for (unsigned int i = 0; i < lines; ++i)
+        width = std::max(width, TextRenderer::TextWidth(m_Lines[i], HUD_TEXT_SCALE));
+    float height = lines * HUD_LINE_HEIGHT + GRAPH_HEIGHT;
+    m_Text.DrawRect(HUD_POSITION - HUD_PADDING, glm::vec2(width, height) + 2.0f * HUD_PADDING, BACKGROUND_COLOR);
+
+    glm::vec2 position = HUD_POSITION;
+    for (unsigned int i = 0; i < lines; ++i)
+    {
+        m_Text.DrawText(m_Lines[i], position, HUD_TEXT_SCALE, TEXT_COLOR);
+        position.y += HUD_LINE_HEIGHT;
+    }
+    DrawGraph(position);
+
+    m_Text.Flush();
+}
+
+void Hud::DrawGraph(glm::vec2 position)
+{
+    // oldest frame on the left, bars grow up from the bottom
+    float bottom = position.y + GRAPH_HEIGHT;
+    unsigned int first = (m_Next + HISTORY - m_Count) % HISTORY;
+    for (unsigned int i = 0; i < m_Count; ++i)
+    {
+        float time = m_FrameTimes[(first + i) % HISTORY];
+        float height = std::min(time, GRAPH_MAX_MS) / GRAPH_MAX_MS * GRAPH_HEIGHT;
+        const glm::vec4& color = time <= TARGET_FRAME_MS ? GOOD_COLOR
+            : time <= 2.0f * TARGET_FRAME_MS ? SLOW_COLOR : BAD_COLOR;
+        m_Text.DrawRect(glm::vec2(position.x + (HISTORY - m_Count) + i, bottom - height),
+            glm::vec2(1.0f, height), color);
+    }
+    float target = TARGET_FRAME_MS / GRAPH_MAX_MS * GRAPH_HEIGHT;
+    m_Text.DrawRect(glm::vec2(position.x, bottom - target), glm::vec2(static_cast<float>(HISTORY), 1.0f),
+        TARGET_LINE_COLOR);
+}
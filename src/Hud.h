@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "TextRenderer.h"
+#include "SpriteRenderer.h"
+#include "GpuTimer.h"
+#include "TextureArray.h"
+
+// what the game did in the frame the HUD reports on
+struct HudFrameStats
+{
+    RenderStats      Render;
+    uint64_t         CollisionTests;
+    TextureResidency Textures;
+};
+
+// Performance overlay: FPS, frame-time percentiles over the last HISTORY frames,
+// a graph of those frames, the frame's draw, sprite and collision counts, and
+// the texture memory resident.
+// Frame times are recorded whether or not the HUD is shown, so it has history
+// as soon as it is switched on.
+class Hud
+{
+public:
+    static const unsigned int HISTORY = 240;
+    // the five stat lines and one per GPU pass
+    static const unsigned int MAX_LINES = 5 + GpuTimer::MAX_PASSES;
+    static const unsigned int LINE_LENGTH = 96;
+private:
+    TextRenderer       m_Text;
+    // milliseconds, a ring of the last m_Count frames ending before m_Next
+    float              m_FrameTimes[HISTORY];
+    unsigned int       m_Next;
+    unsigned int       m_Count;
+    uint64_t           m_LastFrame;
+    std::vector<float> m_Sorted;
+    // formatted in place every frame, so drawing the HUD never allocates
+    char               m_Lines[MAX_LINES][LINE_LENGTH];
+
+    void DrawGraph(glm::vec2 position);
+public:
+    explicit Hud(const glm::mat4& projection);
+
+    // call once per frame; records the time since the previous call
+    void AddFrame();
+    void Draw(const HudFrameStats& stats, const std::vector<GpuTiming>& gpu);
+};
@@ -0,0 +1,148 @@
+#include "InputRecording.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "MappedFile.h"
+
+static const char INPUT_RECORDING_MAGIC[4] = { 'B', 'R', 'K', 'I' };
+
+// LEB128: seven bits per byte, low groups first, high bit set on all but the last
+static void WriteVarint(std::vector<unsigned char>& out, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+static bool ReadVarint(const unsigned char*& data, const unsigned char* end, uint32_t& value)
+{
+    value = 0;
+    for (unsigned int shift = 0; shift < 32 && data < end; shift += 7)
+    {
+        unsigned char byte = *data++;
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+InputRecording::InputRecording()
+    : Hz(0), Width(0), Height(0), BallCount(0)
+{
+
+}
+
+void InputRecording::AddKey(int key, bool down)
+{
+    Events.push_back({ TickCount(), static_cast<uint16_t>(key), down });
+}
+
+void InputRecording::EndTick(uint32_t stateHash)
+{
+    Hashes.push_back(stateHash);
+}
+
+bool InputRecording::Write(const char* path) const
+{
+    std::vector<unsigned char> events;
+    uint32_t lastTick = 0;
+    for (const KeyEvent& event : Events)
+    {
+        WriteVarint(events, event.Tick - lastTick);
+        WriteVarint(events, static_cast<uint32_t>(event.Key) << 1 | (event.Down ? 1 : 0));
+        lastTick = event.Tick;
+    }
+
+    InputRecordingHeader header;
+    std::memcpy(header.Magic, INPUT_RECORDING_MAGIC, sizeof(INPUT_RECORDING_MAGIC));
+    header.Version = INPUT_RECORDING_VERSION;
+    header.Flags = 0;
+    header.Hz = Hz;
+    header.Width = Width;
+    header.Height = Height;
+    header.BallCount = BallCount;
+    header.TickCount = TickCount();
+    header.EventBytes = static_cast<uint32_t>(events.size());
+    header.LevelFileLength = static_cast<uint32_t>(LevelFile.size());
+
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(LevelFile.data(), LevelFile.size());
+    out.write(reinterpret_cast<const char*>(events.data()), events.size());
+    out.write(reinterpret_cast<const char*>(Hashes.data()), Hashes.size() * sizeof(uint32_t));
+    return static_cast<bool>(out);
+}
+
+bool InputRecording::Read(const char* path)
+{
+    Events.clear();
+    Hashes.clear();
+
+    MappedFile file;
+    if (!file.Open(path))
+    {
+        std::cout << "RECORDING FAILED TO OPEN: " << path << std::endl;
+        return false;
+    }
+
+    InputRecordingHeader header;
+    if (file.Size() < sizeof(header))
+    {
+        std::cout << "RECORDING TRUNCATED: " << path << std::endl;
+        return false;
+    }
+    std::memcpy(&header, file.Data(), sizeof(header));
+    if (std::memcmp(header.Magic, INPUT_RECORDING_MAGIC, sizeof(INPUT_RECORDING_MAGIC)) != 0)
+    {
+        std::cout << "NOT A RECORDING: " << path << std::endl;
+        return false;
+    }
+    if (header.Version != INPUT_RECORDING_VERSION)
+    {
+        std::cout << "UNSUPPORTED RECORDING VERSION " << header.Version << ": " << path << std::endl;
+        return false;
+    }
+
+    uint64_t expected = sizeof(header) + static_cast<uint64_t>(header.LevelFileLength)
+        + header.EventBytes + static_cast<uint64_t>(header.TickCount) * sizeof(uint32_t);
+    if (header.Hz == 0 || file.Size() < expected)
+    {
+        std::cout << "RECORDING TRUNCATED: " << path << std::endl;
+        return false;
+    }
+
+    Hz = header.Hz;
+    Width = header.Width;
+    Height = header.Height;
+    BallCount = header.BallCount;
+    const unsigned char* data = file.Data() + sizeof(header);
+    LevelFile.assign(reinterpret_cast<const char*>(data), header.LevelFileLength);
+    data += header.LevelFileLength;
+
+    const unsigned char* eventsEnd = data + header.EventBytes;
+    uint32_t tick = 0;
+    while (data < eventsEnd)
+    {
+        uint32_t delta, code;
+        // keys index the game's 1024 key states
+        if (!ReadVarint(data, eventsEnd, delta) || !ReadVarint(data, eventsEnd, code)
+            || (code >> 1) >= 1024)
+        {
+            std::cout << "RECORDING HAS A BAD EVENT: " << path << std::endl;
+            return false;
+        }
+        tick += delta;
+        Events.push_back({ tick, static_cast<uint16_t>(code >> 1), (code & 1) != 0 });
+    }
+
+    Hashes.resize(header.TickCount);
+    if (!Hashes.empty())
+        std::memcpy(Hashes.data(), eventsEnd, Hashes.size() * sizeof(uint32_t));
+    return true;
+}
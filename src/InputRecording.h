@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Input recording format (.rec), little-endian:
+//
+//   InputRecordingHeader                 36 bytes
+//   level file     LevelFileLength bytes, not terminated
+//   key events     EventBytes bytes; per event two varints, the ticks since the
+//                  previous event and then key << 1 | down
+//   state hashes   TickCount uint32s, Game::StateHash after every tick
+//
+// The simulation only reads its keys and the fixed dt, so the key transitions
+// and the tick rate are all it takes to play a session back exactly. Bump
+// INPUT_RECORDING_VERSION on any layout change.
+struct InputRecordingHeader
+{
+    char     Magic[4];  // "BRKI"
+    uint16_t Version;
+    uint16_t Flags;
+    uint32_t Hz;
+    uint32_t Width;
+    uint32_t Height;
+    uint32_t BallCount;
+    uint32_t TickCount;
+    uint32_t EventBytes;
+    uint32_t LevelFileLength;
+};
+static_assert(sizeof(InputRecordingHeader) == 36, "InputRecordingHeader must match the on-disk layout");
+
+const uint16_t INPUT_RECORDING_VERSION = 1;
+
+// a Game::SetKey call, applied before tick Tick is stepped
+struct KeyEvent
+{
+    uint32_t Tick;
+    uint16_t Key;
+    bool     Down;
+};
+
+class InputRecording
+{
+public:
+    // what the game was started with
+    unsigned int Hz;
+    unsigned int Width, Height;
+    unsigned int BallCount;
+    std::string  LevelFile;
+
+    // in tick order, and in call order within a tick
+    std::vector<KeyEvent> Events;
+    // one per tick recorded
+    std::vector<uint32_t> Hashes;
+
+    InputRecording();
+
+    inline unsigned int TickCount() const { return static_cast<unsigned int>(Hashes.size()); }
+
+    // while recording: keys go to the tick about to be stepped
+    void AddKey(int key, bool down);
+    void EndTick(uint32_t stateHash);
+
+    bool Write(const char* path) const;
+    // validates the header and sizes, printing the reason on failure
+    bool Read(const char* path);
+};
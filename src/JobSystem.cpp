@@ -0,0 +1,202 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+// failed steal attempts before an idle worker goes to sleep
+const unsigned int IDLE_SPINS = 64;
+// ParallelFor makes up to this many ranges per thread, so a thread that
+// finishes early has something left to steal
+const unsigned int RANGES_PER_THREAD = 4;
+
+// the system the calling thread works for, and its queue in it
+struct WorkerIdentity
+{
+    const JobSystem* System;
+    unsigned int     Thread;
+};
+static thread_local WorkerIdentity s_Worker = { nullptr, 0 };
+
+JobSystem::JobSystem(unsigned int threads)
+    : m_Queued(0), m_Sleeping(0), m_Quit(false)
+{
+    threads = std::max(1u, threads);
+    for (unsigned int i = 0; i < threads; ++i)
+        m_Queues.emplace_back(new Queue());
+    for (unsigned int i = 1; i < threads; ++i)
+        m_Workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_Quit = true;
+    }
+    m_WorkReady.notify_all();
+    for (std::thread& worker : m_Workers)
+        worker.join();
+}
+
+unsigned int JobSystem::ThreadIndex() const
+{
+    return s_Worker.System == this ? s_Worker.Thread : 0;
+}
+
+void JobSystem::Schedule(const Function& fn, JobCounter* counter, JobCounter* after)
+{
+    if (counter)
+        counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+
+    Job job = { fn, counter, this };
+    if (after && !after->IsDone())
+    {
+        // checked again under the lock, the counter may have reached zero meanwhile
+        std::lock_guard<std::mutex> lock(after->m_Mutex);
+        if (!after->IsDone())
+        {
+            after->m_Waiting.push_back(std::move(job));
+            return;
+        }
+    }
+    Push(std::move(job));
+}
+
+void JobSystem::Push(Job&& job)
+{
+    Queue& queue = *m_Queues[ThreadIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.Mutex);
+        queue.Jobs.push_back(std::move(job));
+    }
+    // a worker increments m_Sleeping before it checks m_Queued, so either it
+    // sees this job or we see it sleeping
+    m_Queued.fetch_add(1);
+    if (m_Sleeping.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_WorkReady.notify_one();
+    }
+}
+
+bool JobSystem::Pop(unsigned int thread, Job& job)
+{
+    if (m_Queued.load(std::memory_order_relaxed) == 0)
+        return false;
+
+    // newest of our own first, then the oldest of everyone else's
+    for (unsigned int i = 0; i < Size(); ++i)
+    {
+        Queue& queue = *m_Queues[(thread + i) % Size()];
+        std::lock_guard<std::mutex> lock(queue.Mutex);
+        if (queue.Head == queue.Jobs.size())
+            continue;
+        if (i == 0)
+        {
+            job = std::move(queue.Jobs.back());
+            queue.Jobs.pop_back();
+        }
+        else
+            job = std::move(queue.Jobs[queue.Head++]);
+        if (queue.Head == queue.Jobs.size())
+        {
+            queue.Jobs.clear();
+            queue.Head = 0;
+        }
+        m_Queued.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::Execute(Job& job)
+{
+    job.Function();
+
+    JobCounter* counter = job.Counter;
+    if (!counter)
+        return;
+
+    // counting down under the counter's lock keeps reaching zero and releasing
+    // the waiting jobs in one step, so Schedule can't add a job in between
+    std::vector<Job> released;
+    {
+        std::lock_guard<std::mutex> lock(counter->m_Mutex);
+        if (counter->m_Pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            released.swap(counter->m_Waiting);
+    }
+    for (Job& waiting : released)
+        waiting.System->Push(std::move(waiting));
+}
+
+bool JobSystem::RunOne()
+{
+    Job job;
+    if (!Pop(ThreadIndex(), job))
+        return false;
+    Execute(job);
+    return true;
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+    while (!counter.IsDone())
+    {
+        if (!RunOne())
+            std::this_thread::yield();
+    }
+}
+
+void JobSystem::ParallelFor(unsigned int count, unsigned int minChunk, const RangeFunction& fn)
+{
+    if (count == 0)
+        return;
+
+    unsigned int ranges = count / std::max(1u, minChunk);
+    ranges = std::min(ranges, Size() * RANGES_PER_THREAD);
+    if (ranges <= 1 || Size() == 1)
+    {
+        fn(0, count, ThreadIndex());
+        return;
+    }
+
+    // sizes differ by at most one, the remainder goes to the first ranges
+    unsigned int base = count / ranges;
+    unsigned int extra = count % ranges;
+    auto runRange = [this, &fn, base, extra](unsigned int range)
+    {
+        unsigned int begin = range * base + std::min(range, extra);
+        unsigned int end = begin + base + (range < extra ? 1 : 0);
+        fn(begin, end, ThreadIndex());
+    };
+
+    JobCounter counter;
+    for (unsigned int range = 1; range < ranges; ++range)
+        Schedule([&runRange, range]() { runRange(range); }, &counter);
+    runRange(0);
+    Wait(counter);
+}
+
+void JobSystem::WorkerLoop(unsigned int thread)
+{
+    s_Worker = { this, thread };
+    unsigned int idle = 0;
+    while (!m_Quit.load(std::memory_order_relaxed))
+    {
+        if (RunOne())
+        {
+            idle = 0;
+            continue;
+        }
+        if (++idle < IDLE_SPINS)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_Sleeping.fetch_add(1);
+        m_WorkReady.wait(lock, [this] { return m_Quit.load() || m_Queued.load() > 0; });
+        m_Sleeping.fetch_sub(1);
+        idle = 0;
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem;
+class JobCounter;
+
+struct Job
+{
+    std::function<void()> Function;
+    JobCounter*           Counter;
+    JobSystem*            System;
+};
+
+// Counts unfinished jobs. A job scheduled against a counter adds one to it and
+// takes one off when it finishes. Jobs can also be held back until a counter
+// reaches zero, which is how dependencies are expressed. A counter must outlive
+// every job counted by it or waiting on it.
+class JobCounter
+{
+private:
+    std::atomic<unsigned int> m_Pending;
+    std::mutex                m_Mutex;
+    // jobs to schedule once m_Pending reaches zero, guarded by m_Mutex
+    std::vector<Job>          m_Waiting;
+
+    friend class JobSystem;
+public:
+    JobCounter() : m_Pending(0) { }
+    // the job that brought the count to zero may still hold the lock
+    ~JobCounter() { std::lock_guard<std::mutex> lock(m_Mutex); }
+
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    inline bool IsDone() const { return m_Pending.load(std::memory_order_acquire) == 0; }
+};
+
+// Work-stealing job scheduler. Every thread has its own queue: a thread pushes
+// and pops at the back of its queue, so it runs its latest, cache-warm jobs
+// first, and idle workers steal from the front of the others'. Waiting never
+// blocks a thread while there is work; Wait runs queued jobs until the counter
+// is done. Workers sleep only when every queue is empty.
+//
+// The thread that owns the system is queue 0. Only one thread that isn't a
+// worker may use a system at a time.
+class JobSystem
+{
+public:
+    typedef std::function<void()> Function;
+    // fn(begin, end, thread) processes [begin, end); thread is in [0, Size()),
+    // and a thread runs one range at a time unless fn itself waits on jobs
+    typedef std::function<void(unsigned int, unsigned int, unsigned int)> RangeFunction;
+
+    // threads counts the calling thread, so threads - 1 workers are started
+    explicit JobSystem(unsigned int threads);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    inline unsigned int Size() const { return static_cast<unsigned int>(m_Queues.size()); }
+
+    // queues fn on the calling thread's queue. counter, if given, counts the job
+    // until it finishes; after, if given, has to reach zero before it starts
+    void Schedule(const Function& fn, JobCounter* counter = nullptr, JobCounter* after = nullptr);
+
+    // runs one queued job on the calling thread, stealing if its own queue is
+    // empty. false if there was nothing to run
+    bool RunOne();
+
+    // helps run jobs until counter is done
+    void Wait(JobCounter& counter);
+
+    // splits [0, count) into ranges of at least minChunk, a few per thread so
+    // that stealing can even out uneven ranges, and returns once all are done.
+    // Short ranges run inline on the caller
+    void ParallelFor(unsigned int count, unsigned int minChunk, const RangeFunction& fn);
+
+    // the calling thread's queue in this system: a worker's own, 0 for any other
+    unsigned int ThreadIndex() const;
+private:
+    // the jobs in [Head, Jobs.size()); the vector is only cleared once it
+    // drains, so a warmed-up queue never allocates
+    struct Queue
+    {
+        std::mutex       Mutex;
+        std::vector<Job> Jobs;
+        size_t           Head = 0;
+    };
+
+    std::vector<std::unique_ptr<Queue>> m_Queues;
+    std::vector<std::thread>            m_Workers;
+
+    // jobs sitting in queues, so idle workers know whether to sleep
+    std::atomic<unsigned int> m_Queued;
+    std::atomic<unsigned int> m_Sleeping;
+    std::atomic<bool>         m_Quit;
+    std::mutex                m_SleepMutex;
+    std::condition_variable   m_WorkReady;
+
+    void Push(Job&& job);
+    bool Pop(unsigned int thread, Job& job);
+    void Execute(Job& job);
+    void WorkerLoop(unsigned int thread);
+};
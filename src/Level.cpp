@@ -1,81 +1,299 @@
 #include "Level.h"
 
-#include <fstream>
-#include <sstream>
+#include <algorithm>
+#include <charconv>
 #include <iostream>
+#include <cstring>
 
-void Level::Load(const char* file, unsigned int levelWidth, unsigned int levelHeight)
+#include "LevelFile.h"
+#include "MappedFile.h"
+#include "Profiler.h"
+
+// brick colors indexed by BrickSet::ColorIndex, which is the tile code
+static const glm::vec3 BRICK_COLORS[] = {
+    glm::vec3(1.0f),                // unknown tile codes
+    glm::vec3(0.8f, 0.8f, 0.7f),    // 1: solid
+    glm::vec3(0.2f, 0.6f, 1.0f),
+    glm::vec3(0.0f, 0.7f, 0.0f),
+    glm::vec3(0.8f, 0.8f, 0.4f),
+    glm::vec3(1.0f, 0.5f, 0.0f)
+};
+static const unsigned int BRICK_COLOR_COUNT = sizeof(BRICK_COLORS) / sizeof(BRICK_COLORS[0]);
+
+bool ParseTextLevel(const char* data, size_t size, std::vector<unsigned char>& tiles,
+    unsigned int& width, unsigned int& height, std::string& error)
 {
-    Bricks.clear();
-    unsigned int tileCode;
-    Level level;
-    std::string line;
-    std::ifstream fstream(file);
-    std::vector<std::vector<unsigned int>> tileData;
-    if (fstream)
+    tiles.clear();
+    width = height = 0;
+    // every tile takes at least a digit and a separator
+    tiles.reserve(size / 2 + 1);
+
+    const char* p = data;
+    const char* end = data + size;
+    unsigned int line = 0, firstLine = 0;
+    while (p < end)
     {
-        while (std::getline(fstream, line))
+        line++;
+        const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!eol)
+            eol = end;
+
+        unsigned int x = 0;
+        for (;;)
+        {
+            while (p < eol && (*p == ' ' || *p == '\t' || *p == '\r'))
+                p++;
+            if (p == eol)
+                break;
+            unsigned int tileCode;
+            std::from_chars_result result = std::from_chars(p, eol, tileCode);
+            // codes too big to parse still end up clamped like any other big code
+            if (result.ec == std::errc::result_out_of_range)
+                tileCode = 255;
+            else if (result.ec != std::errc() || (result.ptr < eol && *result.ptr != ' ' &&
+                *result.ptr != '\t' && *result.ptr != '\r'))
+            {
+                const char* bad = result.ec != std::errc() ? p : result.ptr;
+                error = "line " + std::to_string(line) + ": unexpected character '" + *bad + "'";
+                return false;
+            }
+            tiles.push_back(static_cast<unsigned char>(std::min(tileCode, 255u)));
+            x++;
+            p = result.ptr;
+        }
+        p = eol < end ? eol + 1 : end;
+
+        // blank lines don't count as rows
+        if (x == 0)
+            continue;
+        if (height == 0)
         {
-            std::istringstream sstream(line);
-            std::vector<unsigned int> row;
-            while (sstream >> tileCode)
-                row.push_back(tileCode);
-            tileData.push_back(row);
+            width = x;
+            firstLine = line;
         }
-        if (tileData.size() > 0)
-            init(tileData, levelWidth, levelHeight);
+        else if (x != width)
+        {
+            error = "line " + std::to_string(line) + " has " + std::to_string(x) + " tiles, line " +
+                std::to_string(firstLine) + " has " + std::to_string(width);
+            return false;
+        }
+        height++;
+    }
+
+    if (height == 0)
+    {
+        error = "no tiles";
+        return false;
+    }
+    return true;
+}
+
+bool ReadTextLevel(const char* file, std::vector<unsigned char>& tiles,
+    unsigned int& width, unsigned int& height, std::string& error)
+{
+    // map the whole file and parse it in one pass
+    MappedFile text;
+    if (!text.Open(file))
+    {
+        error = "can't open the file, or it is empty";
+        return false;
+    }
+    return ParseTextLevel(reinterpret_cast<const char*>(text.Data()), text.Size(),
+        tiles, width, height, error);
+}
+
+bool ConvertLevel(const char* textFile, const char* binaryFile)
+{
+    std::vector<unsigned char> tiles;
+    unsigned int width, height;
+    std::string error;
+    if (!ReadTextLevel(textFile, tiles, width, height, error))
+    {
+        std::cout << "LEVEL FAILED TO LOAD: " << textFile << ": " << error << std::endl;
+        return false;
+    }
+    return WriteLevelFile(binaryFile, tiles.data(), width, height);
+}
+
+bool Level::Load(const char* file, unsigned int levelWidth, unsigned int levelHeight)
+{
+    PROFILE_ZONE("LoadLevel");
+    Bricks.Clear();
+    m_Grid.clear();
+    m_GridWidth = m_GridHeight = 0;
+
+    size_t length = std::strlen(file);
+    if (length >= 4 && std::strcmp(file + length - 4, ".lvl") == 0)
+        return LoadBinary(file, levelWidth, levelHeight);
+    return LoadText(file, levelWidth, levelHeight);
+}
+
+bool Level::LoadText(const char* file, unsigned int levelWidth, unsigned int levelHeight)
+{
+    std::vector<unsigned char> tiles;
+    unsigned int width, height;
+    std::string error;
+    if (!ReadTextLevel(file, tiles, width, height, error))
+    {
+        std::cout << "LEVEL FAILED TO LOAD: " << file << ": " << error << std::endl;
+        return false;
     }
+    init(tiles.data(), width, height, levelWidth, levelHeight);
+    return true;
+}
+
+bool Level::LoadBinary(const char* file, unsigned int levelWidth, unsigned int levelHeight)
+{
+    // the tiles are read straight out of the mapping, which is released on return
+    LevelFile levelFile;
+    if (!levelFile.Open(file))
+        return false;
+    init(levelFile.Tiles, levelFile.Width, levelFile.Height, levelWidth, levelHeight);
+    return true;
 }
 
+void Level::Reset()
+{
+    if (Bricks.DestroyedCount() == 0)
+        return;
+    Bricks.ClearDestroyed();
+#ifndef BREAKOUT_HEADLESS
+    UploadBricks();
+#endif
+}
+
+#ifndef BREAKOUT_HEADLESS
 void Level::Draw(SpriteRenderer& renderer)
 {
-    for (Object& tile : this->Bricks)
-        if (!tile.Destroyed)
-            tile.Draw(renderer);
+    if (Bricks.Size() == 0)
+        return;
+
+    if (renderer.IsBatching())
+    {
+        renderer.DrawBuffer(m_BrickBuffer);
+        return;
+    }
+
+    for (unsigned int i = 0; i < Bricks.Size(); ++i)
+        if (!Bricks.IsDestroyed(i))
+            renderer.DrawSprite(m_BrickSprite, Bricks.Position(i), Bricks.Size(i), 0.0f,
+                BRICK_COLORS[Bricks.ColorIndex[i]]);
+}
+#endif
+
+void Level::SetBrickSprite(unsigned int sprite)
+{
+    m_BrickSprite = sprite;
+#ifndef BREAKOUT_HEADLESS
+    if (Bricks.Size() > 0)
+        UploadBricks();
+#endif
+}
+
+void Level::DestroyBrick(unsigned int index)
+{
+    Bricks.SetDestroyed(index);
+#ifndef BREAKOUT_HEADLESS
+    m_BrickBuffer.Hide(index);
+#endif
+}
+
+void Level::SetDestroyed(const uint64_t* words)
+{
+    const std::vector<uint64_t>& current = Bricks.GetDestroyedWords();
+    // a restore usually lands close to the current state, often on it
+    if (std::equal(current.begin(), current.end(), words))
+        return;
+    Bricks.SetDestroyedWords(words);
+#ifndef BREAKOUT_HEADLESS
+    UploadBricks();
+#endif
+}
+
+void Level::QueryBricks(glm::vec2 min, glm::vec2 max, std::vector<BrickRange>& result) const
+{
+    if (m_Grid.empty() || max.x < 0.0f || max.y < 0.0f ||
+        min.x >= m_CellWidth * m_GridWidth || min.y >= m_CellHeight * m_GridHeight)
+        return;
+
+    // clamp the box to the grid, bricks only exist inside it
+    int x0 = std::max(static_cast<int>(min.x / m_CellWidth), 0);
+    int y0 = std::max(static_cast<int>(min.y / m_CellHeight), 0);
+    int x1 = std::min(static_cast<int>(max.x / m_CellWidth), static_cast<int>(m_GridWidth) - 1);
+    int y1 = std::min(static_cast<int>(max.y / m_CellHeight), static_cast<int>(m_GridHeight) - 1);
+
+    // bricks were added row by row, so the bricks in one row's span of cells
+    // have consecutive indices and rows come out in brick order
+    for (int y = y0; y <= y1; ++y)
+    {
+        const int* row = &m_Grid[y * m_GridWidth];
+        int first = x0;
+        while (first <= x1 && row[first] < 0)
+            first++;
+        if (first > x1)
+            continue;
+        int last = x1;
+        while (row[last] < 0)
+            last--;
+        result.push_back({ static_cast<unsigned int>(row[first]), static_cast<unsigned int>(row[last]) + 1 });
+    }
 }
 
-void Level::init(std::vector<std::vector<unsigned int>> tileData,
+void Level::init(const unsigned char* tiles, unsigned int width, unsigned int height,
     unsigned int lvlWidth, unsigned int lvlHeight)
 {
-    unsigned int height = tileData.size();
-    unsigned int width = tileData[0].size();
     float unit_width = lvlWidth / static_cast<float>(width);
     float unit_height = lvlHeight / height;
 
-    Texture tile("res/textures/container.jpg");
+    m_GridWidth = width;
+    m_GridHeight = height;
+    m_CellWidth = unit_width;
+    m_CellHeight = unit_height;
+    m_Grid.assign(width * height, -1);
+
     for (unsigned int y = 0; y < height; ++y)
     {
         for (unsigned int x = 0; x < width; ++x)
         {
-            if (tileData[y][x] == 1) // non-breakable block
-            {
-                glm::vec2 pos(unit_width * x, unit_height * y);
-                glm::vec2 size(unit_width, unit_height);
-                Object obj(pos, size,
-                    tile,
-                    glm::vec3(0.8f, 0.8f, 0.7f)
-                );
-                obj.IsSolid = true;
-                Bricks.push_back(obj);
-            }
-            else if (tileData[y][x] > 1)
-            {
-                glm::vec3 color = glm::vec3(1.0f);
-                if (tileData[y][x] == 2)
-                    color = glm::vec3(0.2f, 0.6f, 1.0f);
-                else if (tileData[y][x] == 3)
-                    color = glm::vec3(0.0f, 0.7f, 0.0f);
-                else if (tileData[y][x] == 4)
-                    color = glm::vec3(0.8f, 0.8f, 0.4f);
-                else if (tileData[y][x] == 5)
-                    color = glm::vec3(1.0f, 0.5f, 0.0f);
-
-                glm::vec2 pos(unit_width * x, unit_height * y);
-                glm::vec2 size(unit_width, unit_height);
-                Bricks.push_back(
-                    Object(pos, size, tile, color)
-                );
-            }
+            unsigned int tileCode = tiles[y * width + x];
+            if (tileCode == 0) // empty space
+                continue;
+
+            glm::vec2 pos(unit_width * x, unit_height * y);
+            glm::vec2 size(unit_width, unit_height);
+            // codes without a palette entry fall back to plain white
+            unsigned char colorIndex = tileCode < BRICK_COLOR_COUNT ? tileCode : 0;
+            m_Grid[y * width + x] = Bricks.Size();
+            Bricks.Add(pos, size, colorIndex, tileCode == 1); // 1 is a non-breakable block
         }
     }
-}
\ No newline at end of file
+
+#ifndef BREAKOUT_HEADLESS
+    UploadBricks();
+#endif
+}
+
+#ifndef BREAKOUT_HEADLESS
+void Level::UploadBricks()
+{
+    // after the first upload the layout is fixed, so the instances are patched in
+    // place; a reset or restore mid-game then allocates nothing
+    bool patch = m_BrickBuffer.Size() == Bricks.Size();
+    std::vector<SpriteInstance> instances;
+    if (!patch)
+        instances.reserve(Bricks.Size());
+    for (unsigned int i = 0; i < Bricks.Size(); ++i)
+    {
+        // destroyed bricks stay in the buffer collapsed, like SpriteBuffer::Hide leaves them
+        glm::vec2 size = Bricks.IsDestroyed(i) ? glm::vec2(0.0f) : Bricks.Size(i);
+        SpriteInstance instance = { Bricks.Position(i), size, BRICK_COLORS[Bricks.ColorIndex[i]], 0.0f,
+            static_cast<float>(m_BrickSprite) };
+        if (patch)
+            m_BrickBuffer.Update(i, instance);
+        else
+            instances.push_back(instance);
+    }
+    if (!patch)
+        m_BrickBuffer.Set(instances);
+}
+#endif
\ No newline at end of file
@@ -1,18 +1,65 @@
 #pragma once
 
+#include <string>
 #include <vector>
 
-#include "Object.h"
+#include "BrickSet.h"
+#include "SpriteBuffer.h"
+
+// Parses a text level into width * height tile codes, row by row. Codes above
+// 255 are clamped and blank lines are skipped; every row must have as many
+// tiles as the first, otherwise error says which line is wrong.
+bool ParseTextLevel(const char* data, size_t size, std::vector<unsigned char>& tiles,
+    unsigned int& width, unsigned int& height, std::string& error);
+bool ReadTextLevel(const char* file, std::vector<unsigned char>& tiles,
+    unsigned int& width, unsigned int& height, std::string& error);
+
+// Converts a text level to the binary .lvl format.
+bool ConvertLevel(const char* textFile, const char* binaryFile);
 
 class Level
 {
 public:
-    std::vector<Object> Bricks;
-    Level() { }
-    void Load(const char* file, unsigned int levelWidth, unsigned int levelHeight);
+    BrickSet Bricks;
+    Level() : m_BrickSprite(0), m_GridWidth(0), m_GridHeight(0), m_CellWidth(0.0f), m_CellHeight(0.0f) { }
+    // loads a binary .lvl file if the name ends in .lvl, otherwise the text format
+    bool Load(const char* file, unsigned int levelWidth, unsigned int levelHeight);
+    // restore the level to how it was loaded without going back to the file;
+    // only the destroyed flags change during play, so this clears them
+    void Reset();
+#ifndef BREAKOUT_HEADLESS
     void Draw(SpriteRenderer& renderer);
+#endif
+    // layer of the sprite array every brick is drawn with
+    void SetBrickSprite(unsigned int sprite);
+    // bricks must be destroyed through here so the GPU copy stays in sync
+    void DestroyBrick(unsigned int index);
+    // sets every brick's destroyed flag at once from a copy of Bricks.GetDestroyedWords()
+    void SetDestroyed(const uint64_t* words);
+    // appends the bricks in grid cells overlapping the box [min, max] as one
+    // range of indices per row, in the same order they appear in Bricks
+    void QueryBricks(glm::vec2 min, glm::vec2 max, std::vector<BrickRange>& result) const;
 private:
-    // initialize level from tile data
-    void init(std::vector<std::vector<unsigned int>> tileData,
+#ifndef BREAKOUT_HEADLESS
+    // one instance per brick, built in init and patched as bricks are destroyed
+    SpriteBuffer m_BrickBuffer;
+#endif
+
+    unsigned int m_BrickSprite;
+
+    // bricks sit on a regular tile grid, so the broadphase is one cell per tile
+    // holding the index of the brick in it, or -1 for an empty tile
+    unsigned int     m_GridWidth, m_GridHeight;
+    float            m_CellWidth, m_CellHeight;
+    std::vector<int> m_Grid;
+
+    bool LoadText(const char* file, unsigned int levelWidth, unsigned int levelHeight);
+    bool LoadBinary(const char* file, unsigned int levelWidth, unsigned int levelHeight);
+
+    // initialize level from width * height tile codes, row by row
+    void init(const unsigned char* tiles, unsigned int width, unsigned int height,
               unsigned int levelWidth, unsigned int levelHeight);
+#ifndef BREAKOUT_HEADLESS
+    void UploadBricks();
+#endif
 };
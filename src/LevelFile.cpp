@@ -0,0 +1,78 @@
+#include "LevelFile.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+static const char LEVEL_FILE_MAGIC[4] = { 'B', 'R', 'K', 'L' };
+
+LevelFile::LevelFile()
+    : Width(0), Height(0), Tiles(nullptr), Metadata(nullptr)
+{
+
+}
+
+bool LevelFile::Open(const char* path)
+{
+    Width = Height = 0;
+    Tiles = Metadata = nullptr;
+
+    if (!m_File.Open(path))
+    {
+        std::cout << "LEVEL FAILED TO OPEN: " << path << std::endl;
+        return false;
+    }
+
+    LevelFileHeader header;
+    if (m_File.Size() < sizeof(header))
+    {
+        std::cout << "LEVEL FILE TRUNCATED: " << path << std::endl;
+        return false;
+    }
+    std::memcpy(&header, m_File.Data(), sizeof(header));
+    if (std::memcmp(header.Magic, LEVEL_FILE_MAGIC, sizeof(LEVEL_FILE_MAGIC)) != 0)
+    {
+        std::cout << "NOT A LEVEL FILE: " << path << std::endl;
+        return false;
+    }
+    if (header.Version != LEVEL_FILE_VERSION)
+    {
+        std::cout << "UNSUPPORTED LEVEL FILE VERSION " << header.Version << ": " << path << std::endl;
+        return false;
+    }
+
+    // sizes are checked in 64 bits so huge dimensions can't wrap around
+    uint64_t tileCount = static_cast<uint64_t>(header.Width) * header.Height;
+    uint64_t expected = sizeof(header) + tileCount * ((header.Flags & LEVEL_FILE_HAS_METADATA) ? 2 : 1);
+    if (tileCount == 0 || m_File.Size() < expected)
+    {
+        std::cout << "LEVEL FILE TRUNCATED: " << path << std::endl;
+        return false;
+    }
+
+    Width = header.Width;
+    Height = header.Height;
+    Tiles = m_File.Data() + sizeof(header);
+    if (header.Flags & LEVEL_FILE_HAS_METADATA)
+        Metadata = Tiles + tileCount;
+    return true;
+}
+
+bool WriteLevelFile(const char* path, const unsigned char* tiles, unsigned int width,
+    unsigned int height, const unsigned char* metadata)
+{
+    LevelFileHeader header;
+    std::memcpy(header.Magic, LEVEL_FILE_MAGIC, sizeof(LEVEL_FILE_MAGIC));
+    header.Version = LEVEL_FILE_VERSION;
+    header.Flags = metadata ? LEVEL_FILE_HAS_METADATA : 0;
+    header.Width = width;
+    header.Height = height;
+
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    size_t tileCount = static_cast<size_t>(width) * height;
+    out.write(reinterpret_cast<const char*>(tiles), tileCount);
+    if (metadata)
+        out.write(reinterpret_cast<const char*>(metadata), tileCount);
+    return static_cast<bool>(out);
+}
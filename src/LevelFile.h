@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+
+#include "MappedFile.h"
+
+// Binary level format (.lvl), little-endian:
+//
+//   LevelFileHeader                     16 bytes
+//   tile codes     Width * Height bytes, row by row from the top, 0 = empty
+//   tile metadata  Width * Height bytes, only if LEVEL_FILE_HAS_METADATA is set
+//
+// Tiles are stored exactly as Level consumes them, so a mapped file is used in
+// place with no parsing. Bump LEVEL_FILE_VERSION on any layout change.
+struct LevelFileHeader
+{
+    char     Magic[4];  // "BRKL"
+    uint16_t Version;
+    uint16_t Flags;
+    uint32_t Width;
+    uint32_t Height;
+};
+static_assert(sizeof(LevelFileHeader) == 16, "LevelFileHeader must match the on-disk layout");
+
+const uint16_t LEVEL_FILE_VERSION = 1;
+const uint16_t LEVEL_FILE_HAS_METADATA = 1 << 0;
+
+// A memory-mapped .lvl file. Tiles and Metadata point into the mapping and
+// stay valid until the LevelFile is destroyed or reopened.
+class LevelFile
+{
+private:
+    MappedFile m_File;
+public:
+    unsigned int         Width, Height;
+    const unsigned char* Tiles;
+    const unsigned char* Metadata; // null when the file has none
+
+    LevelFile();
+
+    // validates the header and size, printing the reason on failure
+    bool Open(const char* path);
+};
+
+// Writes tiles (Width * Height codes, row-major) as a .lvl file; metadata
+// may be null. Returns false if the file can't be written.
+bool WriteLevelFile(const char* path, const unsigned char* tiles, unsigned int width,
+    unsigned int height, const unsigned char* metadata = nullptr);
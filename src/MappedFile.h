@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+// A read-only view of a whole file mapped into memory. Pages are loaded by the
+// OS on first touch, so opening is cheap however big the file is.
+class MappedFile
+{
+private:
+    const unsigned char* m_Data;
+    size_t               m_Size;
+#ifdef _WIN32
+    void*                m_File;
+    void*                m_Mapping;
+#endif
+
+    void Close();
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // returns false if the file can't be opened or is empty
+    bool Open(const char* path);
+
+    inline const unsigned char* Data() const { return m_Data; }
+    inline size_t Size() const { return m_Size; }
+};
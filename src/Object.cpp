@@ -1,9 +1,16 @@
 #include "Object.h"
 
-Object::Object(glm::vec2 pos, glm::vec2 size, Texture sprite, glm::vec3 color, glm::vec2 velocity, float rotation)
+Object::Object(glm::vec2 pos, glm::vec2 size, unsigned int sprite, glm::vec3 color, glm::vec2 velocity, float rotation)
     : Position(pos), Size(size), Velocity(velocity), Color(color), Rotation(rotation), Sprite(sprite), IsSolid(false), Destroyed(false) { }
 
+#ifndef BREAKOUT_HEADLESS
 void Object::Draw(SpriteRenderer& renderer)
 {
-    renderer.DrawSprite(this->Sprite, this->Position, this->Size, this->Rotation, this->Color);
-}
\ No newline at end of file
+    DrawAt(renderer, this->Position);
+}
+
+void Object::DrawAt(SpriteRenderer& renderer, glm::vec2 position)
+{
+    renderer.DrawSprite(this->Sprite, position, this->Size, this->Rotation, this->Color);
+}
+#endif
\ No newline at end of file
@@ -2,7 +2,6 @@
 
 #include "glm/glm.hpp"
 
-#include "Texture.h"
 #include "SpriteRenderer.h"
 
 class Object
@@ -15,10 +14,15 @@ public:
     bool        IsSolid;
     bool        Destroyed;
 
-    Texture    Sprite;
+    // layer of the sprite array; 0 when the game runs headless
+    unsigned int Sprite;
 
-    Object(glm::vec2 pos, glm::vec2 size, Texture sprite, glm::vec3 color = glm::vec3(1.0f), glm::vec2 velocity = glm::vec2(0.0f, 0.0f), float rotation = 0.0f);
+    Object(glm::vec2 pos, glm::vec2 size, unsigned int sprite, glm::vec3 color = glm::vec3(1.0f), glm::vec2 velocity = glm::vec2(0.0f, 0.0f), float rotation = 0.0f);
 
+#ifndef BREAKOUT_HEADLESS
     virtual void Draw(SpriteRenderer& renderer);
+    // draw at a position other than the simulated one, e.g. interpolated between steps
+    void DrawAt(SpriteRenderer& renderer, glm::vec2 position);
+#endif
 };
 
@@ -0,0 +1,131 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct ProfileEvent
+{
+    const char* Name;
+    uint64_t    Start;
+    uint64_t    End;
+};
+
+// written only by its own thread; Count is published with release so the
+// writer of a trace sees finished events
+struct ProfileBuffer
+{
+    unsigned int               Thread;
+    // shown instead of "thread N" for tracks that aren't a thread
+    const char*                Track;
+    std::vector<ProfileEvent>  Events;
+    std::atomic<uint64_t>      Count;
+
+    ProfileBuffer(unsigned int thread, const char* track)
+        : Thread(thread), Track(track), Events(Profiler::EVENTS_PER_THREAD), Count(0) { }
+};
+
+// buffers live until exit, so a thread that has ended still shows up in the trace
+static std::mutex s_BuffersMutex;
+static std::vector<std::unique_ptr<ProfileBuffer>> s_Buffers;
+
+static ProfileBuffer* NewBuffer(const char* track)
+{
+    std::lock_guard<std::mutex> lock(s_BuffersMutex);
+    s_Buffers.emplace_back(new ProfileBuffer(static_cast<unsigned int>(s_Buffers.size()), track));
+    return s_Buffers.back().get();
+}
+
+static ProfileBuffer& ThreadBuffer()
+{
+    thread_local ProfileBuffer* buffer = NewBuffer(nullptr);
+    return *buffer;
+}
+
+static ProfileBuffer& GpuBuffer()
+{
+    static ProfileBuffer* buffer = NewBuffer("GPU");
+    return *buffer;
+}
+
+std::atomic<bool> Profiler::s_Enabled(true);
+
+void Profiler::SetEnabled(bool enabled)
+{
+    s_Enabled.store(enabled, std::memory_order_relaxed);
+}
+
+uint64_t Profiler::Now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void Append(ProfileBuffer& buffer, const char* name, uint64_t start, uint64_t end)
+{
+    uint64_t count = buffer.Count.load(std::memory_order_relaxed);
+    buffer.Events[count % Profiler::EVENTS_PER_THREAD] = { name, start, end };
+    buffer.Count.store(count + 1, std::memory_order_release);
+}
+
+void Profiler::Record(const char* name, uint64_t start, uint64_t end)
+{
+    Append(ThreadBuffer(), name, start, end);
+}
+
+void Profiler::RecordGpu(const char* name, uint64_t start, uint64_t end)
+{
+    Append(GpuBuffer(), name, start, end);
+}
+
+bool Profiler::WriteChromeTrace(const char* path)
+{
+    std::ofstream out(path);
+    if (!out)
+        return false;
+
+    // timestamps are relative to the earliest start so they stay readable; zones
+    // are recorded when they end, so that isn't necessarily the oldest event
+    std::lock_guard<std::mutex> lock(s_BuffersMutex);
+    std::vector<uint64_t> counts;
+    uint64_t origin = UINT64_MAX;
+    for (const auto& buffer : s_Buffers)
+    {
+        uint64_t count = buffer->Count.load(std::memory_order_acquire);
+        counts.push_back(count);
+        for (uint64_t i = count > EVENTS_PER_THREAD ? count - EVENTS_PER_THREAD : 0; i < count; ++i)
+            origin = std::min(origin, buffer->Events[i % EVENTS_PER_THREAD].Start);
+    }
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"traceEvents\":[\n";
+    bool firstEvent = true;
+    for (size_t b = 0; b < s_Buffers.size(); ++b)
+    {
+        const ProfileBuffer* buffer = s_Buffers[b].get();
+        out << (firstEvent ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+            << buffer->Thread << ",\"args\":{\"name\":\"";
+        if (buffer->Track)
+            out << buffer->Track << "\"}}";
+        else
+            out << "thread " << buffer->Thread << "\"}}";
+        firstEvent = false;
+
+        uint64_t count = counts[b];
+        uint64_t first = count > EVENTS_PER_THREAD ? count - EVENTS_PER_THREAD : 0;
+        for (uint64_t i = first; i < count; ++i)
+        {
+            const ProfileEvent& event = buffer->Events[i % EVENTS_PER_THREAD];
+            // complete events, in microseconds
+            out << ",\n{\"name\":\"" << event.Name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->Thread
+                << ",\"ts\":" << (event.Start - origin) / 1000.0 << ",\"dur\":" << (event.End - event.Start) / 1000.0 << "}";
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
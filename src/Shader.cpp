@@ -4,31 +4,45 @@
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <vector>
+#include <filesystem>
+#include <cstdio>
+#include <cstring>
 
 #include "Shader.h"
+#include "GLState.h"
 
 Shader::Shader(const std::string& vertexFilepath, const std::string& fragmentFilepath)
     : m_VertexFilepath(vertexFilepath), m_FragmentFilepath(fragmentFilepath), m_ID(0)
 {
     std::string vertexSource = ParseShader(vertexFilepath);
     std::string fragmentSource = ParseShader(fragmentFilepath);
-    m_ID = CreateShader(vertexSource, fragmentSource);
-    glUseProgram(m_ID);
+
+    // reading the sources is cheap, compiling and linking them is what we skip
+    std::string cachePath = ProgramCachePath();
+    uint64_t key = ProgramCacheKey(vertexSource, fragmentSource);
+    m_ID = LoadProgramBinary(cachePath, key);
+    if (!m_ID)
+    {
+        m_ID = CreateShader(vertexSource, fragmentSource);
+        SaveProgramBinary(cachePath, key);
+    }
+    GLState::UseProgram(m_ID);
 }
 
 Shader::~Shader()
 {
-    glDeleteProgram(m_ID);
+    GLState::DeleteProgram(m_ID);
 }
 
 void Shader::Bind() const
 {
-    glUseProgram(m_ID);
+    GLState::UseProgram(m_ID);
 }
 
 void Shader::Unbind() const
 {
-    glUseProgram(0);
+    GLState::UseProgram(0);
 }
 
 void Shader::SetUniform1i(const std::string& name, int v0)
@@ -37,6 +51,18 @@ void Shader::SetUniform1i(const std::string& name, int v0)
     glUniform1i(location, v0);
 }
 
+void Shader::SetUniform1f(const std::string& name, float v0)
+{
+    int location = GetUniformLocation(name);
+    glUniform1f(location, v0);
+}
+
+void Shader::SetUniform2f(const std::string& name, const glm::vec2& vec2)
+{
+    int location = GetUniformLocation(name);
+    glUniform2f(location, vec2.x, vec2.y);
+}
+
 void Shader::SetUniform3f(const std::string& name, const glm::vec3& vec3)
 {
     int location = GetUniformLocation(name);
@@ -55,11 +81,42 @@ void Shader::SetUniformMat4f(const std::string& name, const glm::mat4& matrix)
     glUniformMatrix4fv(location, 1, GL_FALSE, &matrix[0][0]);
 }
 
+Uniform Shader::GetUniform(const std::string& name)
+{
+    return Uniform{ GetUniformLocation(name) };
+}
+
+void Shader::SetUniform1i(Uniform uniform, int v0)
+{
+    glUniform1i(uniform.Location, v0);
+}
+
+void Shader::SetUniform1f(Uniform uniform, float v0)
+{
+    glUniform1f(uniform.Location, v0);
+}
+
+void Shader::SetUniform3f(Uniform uniform, const glm::vec3& vec3)
+{
+    glUniform3f(uniform.Location, vec3.x, vec3.y, vec3.z);
+}
+
+void Shader::SetUniform4f(Uniform uniform, const glm::vec4& vec4)
+{
+    glUniform4f(uniform.Location, vec4.x, vec4.y, vec4.z, vec4.w);
+}
+
+void Shader::SetUniformMat4f(Uniform uniform, const glm::mat4& matrix)
+{
+    glUniformMatrix4fv(uniform.Location, 1, GL_FALSE, &matrix[0][0]);
+}
+
 int Shader::GetUniformLocation(const std::string& name)
 {
-    if (m_UniformLocationCache.count(name))
+    auto cached = m_UniformLocationCache.find(name);
+    if (cached != m_UniformLocationCache.end())
     {
-        return m_UniformLocationCache[name];
+        return cached->second;
     }
 
     int location = glGetUniformLocation(m_ID, name.c_str());
@@ -133,6 +190,8 @@ unsigned int Shader::CreateShader(const std::string& vertexShader, const std::st
 
     glAttachShader(program, vs);
     glAttachShader(program, fs);
+    if (GLEW_ARB_get_program_binary)
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glLinkProgram(program);
     glValidateProgram(program);
 
@@ -143,3 +202,103 @@ unsigned int Shader::CreateShader(const std::string& vertexShader, const std::st
     return program;
 }
 
+// relative to the working directory, like res/
+static const char* PROGRAM_CACHE_DIRECTORY = "shadercache";
+static const uint32_t PROGRAM_CACHE_MAGIC = 0x50485342; // "BSHP"
+
+struct ProgramCacheHeader
+{
+    uint32_t Magic;
+    uint32_t Format; // the binaryFormat glGetProgramBinary returned
+    uint64_t Key;
+};
+
+static uint64_t Fnv1a(uint64_t hash, const char* data, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::string Shader::ProgramCachePath() const
+{
+    uint64_t name = 14695981039346656037ull;
+    name = Fnv1a(name, m_VertexFilepath.c_str(), m_VertexFilepath.size() + 1);
+    name = Fnv1a(name, m_FragmentFilepath.c_str(), m_FragmentFilepath.size() + 1);
+
+    char file[32];
+    snprintf(file, sizeof(file), "%016llx.bin", static_cast<unsigned long long>(name));
+    return std::string(PROGRAM_CACHE_DIRECTORY) + "/" + file;
+}
+
+uint64_t Shader::ProgramCacheKey(const std::string& vertexSource, const std::string& fragmentSource)
+{
+    uint64_t key = 14695981039346656037ull;
+    // the terminators keep "ab" + "c" from hashing the same as "a" + "bc"
+    key = Fnv1a(key, vertexSource.c_str(), vertexSource.size() + 1);
+    key = Fnv1a(key, fragmentSource.c_str(), fragmentSource.size() + 1);
+    const GLenum driverStrings[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+    for (GLenum name : driverStrings)
+    {
+        const char* value = reinterpret_cast<const char*>(glGetString(name));
+        if (value)
+            key = Fnv1a(key, value, strlen(value) + 1);
+    }
+    return key;
+}
+
+unsigned int Shader::LoadProgramBinary(const std::string& path, uint64_t key)
+{
+    GLint formats = 0;
+    if (GLEW_ARB_get_program_binary)
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats == 0)
+        return 0;
+
+    std::ifstream stream(path, std::ios::binary);
+    ProgramCacheHeader header;
+    if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.Magic != PROGRAM_CACHE_MAGIC || header.Key != key)
+        return 0;
+    std::vector<char> binary((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    if (binary.empty())
+        return 0;
+
+    unsigned int program = glCreateProgram();
+    glProgramBinary(program, header.Format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    // the driver may still reject a binary it wrote, e.g. after an update that
+    // didn't change the version string
+    int linked;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (linked == GL_FALSE)
+    {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+void Shader::SaveProgramBinary(const std::string& path, uint64_t key) const
+{
+    GLint length = 0;
+    if (GLEW_ARB_get_program_binary)
+        glGetProgramiv(m_ID, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(m_ID, length, &length, &format, binary.data());
+
+    // a missing cache only costs a compile, so failures here are silent
+    std::error_code error;
+    std::filesystem::create_directories(PROGRAM_CACHE_DIRECTORY, error);
+    std::ofstream stream(path, std::ios::binary);
+    ProgramCacheHeader header = { PROGRAM_CACHE_MAGIC, format, key };
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.write(binary.data(), length);
+}
\ No newline at end of file
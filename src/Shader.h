@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 
@@ -11,6 +12,13 @@ struct ShaderProgramSource
 	std::string FragmentSource;
 };
 
+// A uniform location resolved once with Shader::GetUniform, so setting it on
+// a hot path costs no string building or hashing
+struct Uniform
+{
+	int Location;
+};
+
 class Shader
 {
 private:
@@ -24,6 +32,14 @@ private:
 	std::string ParseShader(const std::string& filepath);
 	unsigned int CompileShader(const std::string& source, unsigned int type);
 	unsigned int CreateShader(const std::string& vertexShader, const std::string& fragmentShader);
+
+	// Linked programs are cached on disk with glGetProgramBinary, one file per
+	// vertex/fragment pair. The key hashes both sources and the driver strings,
+	// so an edited shader or a driver update falls back to compiling.
+	std::string ProgramCachePath() const;
+	static uint64_t ProgramCacheKey(const std::string& vertexSource, const std::string& fragmentSource);
+	unsigned int LoadProgramBinary(const std::string& path, uint64_t key);
+	void SaveProgramBinary(const std::string& path, uint64_t key) const;
 public:
 	Shader(const std::string& vertexFilepath, const std::string& fragmentFilepath);
 	~Shader();
@@ -36,8 +52,17 @@ public:
 	// Ideally we have a shader system that determines the type of the value we pass it
 	// Also ideally we have a maths library that has a vec4 struct
 	void SetUniform1i(const std::string& name, int v0);
+	void SetUniform1f(const std::string& name, float v0);
+	void SetUniform2f(const std::string& name, const glm::vec2& vec2);
 	void SetUniform3f(const std::string& name, const glm::vec3& vec3);
 	void SetUniform4f(const std::string& name, const glm::vec4& vec4);
 	void SetUniformMat4f(const std::string& name, const glm::mat4& matrix);
+
+	Uniform GetUniform(const std::string& name);
+	void SetUniform1i(Uniform uniform, int v0);
+	void SetUniform1f(Uniform uniform, float v0);
+	void SetUniform3f(Uniform uniform, const glm::vec3& vec3);
+	void SetUniform4f(Uniform uniform, const glm::vec4& vec4);
+	void SetUniformMat4f(Uniform uniform, const glm::mat4& matrix);
 };
 
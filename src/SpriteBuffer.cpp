@@ -0,0 +1,61 @@
+#include "SpriteBuffer.h"
+
+#include <GL/glew.h>
+
+#include "GLState.h"
+
+SpriteBuffer::SpriteBuffer()
+    : m_VAO(0), m_VBO(0), m_UploadedCount(0), m_DirtyBegin(0), m_DirtyEnd(0) { }
+
+SpriteBuffer::~SpriteBuffer()
+{
+    if (m_VAO)
+        GLState::DeleteVertexArray(m_VAO);
+    if (m_VBO)
+        glDeleteBuffers(1, &m_VBO);
+}
+
+SpriteBuffer::SpriteBuffer(const SpriteBuffer& other)
+    : m_Instances(other.m_Instances), m_VAO(0), m_VBO(0), m_UploadedCount(0),
+    m_DirtyBegin(0), m_DirtyEnd(other.Size()) { }
+
+SpriteBuffer& SpriteBuffer::operator=(const SpriteBuffer& other)
+{
+    if (this != &other)
+        Set(other.m_Instances);
+    return *this;
+}
+
+void SpriteBuffer::Set(const std::vector<SpriteInstance>& instances)
+{
+    m_Instances = instances;
+    MarkDirty(0, Size());
+}
+
+void SpriteBuffer::Update(unsigned int index, const SpriteInstance& instance)
+{
+    m_Instances[index] = instance;
+    MarkDirty(index, index + 1);
+}
+
+void SpriteBuffer::Hide(unsigned int index)
+{
+    m_Instances[index].Size = glm::vec2(0.0f);
+    MarkDirty(index, index + 1);
+}
+
+void SpriteBuffer::MarkDirty(unsigned int begin, unsigned int end)
+{
+    if (m_DirtyBegin == m_DirtyEnd)
+    {
+        m_DirtyBegin = begin;
+        m_DirtyEnd = end;
+    }
+    else
+    {
+        if (begin < m_DirtyBegin)
+            m_DirtyBegin = begin;
+        if (end > m_DirtyEnd)
+            m_DirtyEnd = end;
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+
+#include "SpriteRenderer.h"
+
+// A set of sprite instances that stays resident on the GPU between frames.
+// The whole buffer is uploaded once after Set, after that only the range
+// touched by Update/Hide is re-sent, so drawing an unchanged buffer costs a
+// single instanced draw and no uploads. GL objects are created lazily by
+// SpriteRenderer::DrawBuffer the first time the buffer is drawn.
+class SpriteBuffer
+{
+private:
+    std::vector<SpriteInstance> m_Instances;
+    unsigned int m_VAO;
+    unsigned int m_VBO;
+    unsigned int m_UploadedCount;
+    // [m_DirtyBegin, m_DirtyEnd) is the range that still has to be sent
+    unsigned int m_DirtyBegin, m_DirtyEnd;
+
+    void MarkDirty(unsigned int begin, unsigned int end);
+
+    friend class SpriteRenderer;
+public:
+    SpriteBuffer();
+    ~SpriteBuffer();
+
+    // copies only take the instance data; each copy owns its own GL buffer
+    SpriteBuffer(const SpriteBuffer& other);
+    SpriteBuffer& operator=(const SpriteBuffer& other);
+
+    void Set(const std::vector<SpriteInstance>& instances);
+    void Update(unsigned int index, const SpriteInstance& instance);
+    // collapse an instance to zero size so it rasterizes nothing
+    void Hide(unsigned int index);
+
+    inline unsigned int Size() const { return static_cast<unsigned int>(m_Instances.size()); }
+};
@@ -1,20 +1,45 @@
 #include "SpriteRenderer.h"
 
-SpriteRenderer::SpriteRenderer(Shader& shader)
-    : m_Shader(shader)
+#include <cstddef>
+
+#include "SpriteBuffer.h"
+#include "GLState.h"
+
+SpriteRenderer::SpriteRenderer(const glm::mat4& projection, const TextureArray& sprites)
+    : m_Shader("res/shaders/vertex.shader", "res/shaders/fragment.shader"),
+    m_BatchShader("res/shaders/batch_vertex.shader", "res/shaders/batch_fragment.shader"),
+    m_ModelUniform{ -1 }, m_ColorUniform{ -1 }, m_LayerUniform{ -1 }, m_Sprites(sprites),
+    m_QuadVAO(0), m_QuadVBO(0), m_Batching(false), m_BatchVAO(0), m_InstanceVBO(0),
+    m_InstanceCapacity(0), m_Stats()
 {
+    // the renderer owns its programs; Shader deletes the GL program when it goes out
+    // of scope, so a copy of a caller's local would outlive the program it names.
+    // uniforms go to the current program, so each one is bound before it is set up
+    m_Shader.Bind();
+    m_Shader.SetUniform1i("image", 0);
+    m_Shader.SetUniformMat4f("projection", projection);
+    m_ModelUniform = m_Shader.GetUniform("model");
+    m_ColorUniform = m_Shader.GetUniform("spriteColor");
+    m_LayerUniform = m_Shader.GetUniform("layer");
+    m_BatchShader.Bind();
+    m_BatchShader.SetUniform1i("image", 0);
+    m_BatchShader.SetUniformMat4f("projection", projection);
+
     InitRenderData();
+    InitBatchData();
 }
 
 SpriteRenderer::~SpriteRenderer()
 {
-    glDeleteVertexArrays(1, &m_QuadVAO);
+    GLState::DeleteVertexArray(m_QuadVAO);
+    GLState::DeleteVertexArray(m_BatchVAO);
+    glDeleteBuffers(1, &m_QuadVBO);
+    glDeleteBuffers(1, &m_InstanceVBO);
 }
 
 void SpriteRenderer::InitRenderData()
 {
     // initialise VAO & VBO
-    unsigned int VBO;
     float vertices[] = {
         // pos      // texture coords
         0.0f, 1.0f, 0.0f, 1.0f,
@@ -27,21 +52,66 @@ void SpriteRenderer::InitRenderData()
     };
 
     glGenVertexArrays(1, &m_QuadVAO);
-    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &m_QuadVBO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_QuadVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-    glBindVertexArray(m_QuadVAO);
+    GLState::BindVertexArray(m_QuadVAO);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GLState::BindVertexArray(0);
+}
+
+void SpriteRenderer::InitBatchData()
+{
+    glGenVertexArrays(1, &m_BatchVAO);
+    glGenBuffers(1, &m_InstanceVBO);
+    InitInstanceAttributes(m_BatchVAO, m_InstanceVBO);
+}
+
+void SpriteRenderer::InitInstanceAttributes(unsigned int vao, unsigned int instanceVBO)
+{
+    // instanced VAOs share the unit quad and add one instance buffer on top of it
+    GLState::BindVertexArray(vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_QuadVBO);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    // position + size
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+        (void*)offsetof(SpriteInstance, Position));
+    glVertexAttribDivisor(1, 1);
+    // color + rotation
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+        (void*)offsetof(SpriteInstance, Color));
+    glVertexAttribDivisor(2, 1);
+    // texture layer
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+        (void*)offsetof(SpriteInstance, Layer));
+    glVertexAttribDivisor(3, 1);
+
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GLState::BindVertexArray(0);
 }
 
-void SpriteRenderer::DrawSprite(Texture& texture, glm::vec2 position,
+void SpriteRenderer::DrawSprite(unsigned int sprite, glm::vec2 position,
     glm::vec2 size, float rotate, glm::vec3 color)
 {
+    m_Stats.Sprites++;
+
+    if (m_Batching)
+    {
+        m_Instances.push_back({ position, size, color, rotate, static_cast<float>(sprite) });
+        return;
+    }
+
     m_Shader.Bind();
     glm::mat4 model = glm::mat4(1.0f);
     model = glm::translate(model, glm::vec3(position, 0.0f));
@@ -53,13 +123,107 @@ void SpriteRenderer::DrawSprite(Texture& texture, glm::vec2 position,
 
     model = glm::scale(model, glm::vec3(size, 1.0f));
 
-    m_Shader.SetUniformMat4f("model", model);
-    m_Shader.SetUniform3f("spriteColor", color);
+    m_Shader.SetUniformMat4f(m_ModelUniform, model);
+    m_Shader.SetUniform3f(m_ColorUniform, color);
+    m_Shader.SetUniform1f(m_LayerUniform, static_cast<float>(sprite));
 
-    glActiveTexture(GL_TEXTURE0);
-    texture.Bind();
+    m_Sprites.Bind(0);
 
-    glBindVertexArray(m_QuadVAO);
+    // the VAO is left bound, the next sprite most likely wants it too
+    GLState::BindVertexArray(m_QuadVAO);
     glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindVertexArray(0);
+    m_Stats.DrawCalls++;
+}
+
+void SpriteRenderer::DrawBuffer(SpriteBuffer& buffer)
+{
+    if (buffer.Size() == 0)
+        return;
+
+    // keep submission order with any sprites queued before this buffer
+    FlushBatch();
+
+    if (!buffer.m_VAO)
+    {
+        glGenVertexArrays(1, &buffer.m_VAO);
+        glGenBuffers(1, &buffer.m_VBO);
+        InitInstanceAttributes(buffer.m_VAO, buffer.m_VBO);
+    }
+
+    if (buffer.m_DirtyBegin != buffer.m_DirtyEnd)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer.m_VBO);
+        if (buffer.Size() != buffer.m_UploadedCount)
+        {
+            glBufferData(GL_ARRAY_BUFFER, buffer.Size() * sizeof(SpriteInstance),
+                buffer.m_Instances.data(), GL_STATIC_DRAW);
+            buffer.m_UploadedCount = buffer.Size();
+        }
+        else
+        {
+            // only re-send the instances that changed since the last draw
+            glBufferSubData(GL_ARRAY_BUFFER, buffer.m_DirtyBegin * sizeof(SpriteInstance),
+                (buffer.m_DirtyEnd - buffer.m_DirtyBegin) * sizeof(SpriteInstance),
+                buffer.m_Instances.data() + buffer.m_DirtyBegin);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        buffer.m_DirtyBegin = buffer.m_DirtyEnd = 0;
+    }
+
+    m_BatchShader.Bind();
+    m_Sprites.Bind(0);
+
+    GLState::BindVertexArray(buffer.m_VAO);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, buffer.Size());
+    m_Stats.DrawCalls++;
+    m_Stats.Sprites += buffer.Size();
+}
+
+void SpriteRenderer::BeginBatch()
+{
+    m_Batching = true;
+    m_Instances.clear();
+}
+
+void SpriteRenderer::EndBatch()
+{
+    FlushBatch();
+    m_Batching = false;
+}
+
+void SpriteRenderer::Flush()
+{
+    FlushBatch();
+}
+
+void SpriteRenderer::FlushBatch()
+{
+    if (m_Instances.empty())
+        return;
+
+    unsigned int count = static_cast<unsigned int>(m_Instances.size());
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_InstanceVBO);
+    // grow geometrically so a level with more bricks reallocates only a few times
+    if (count > m_InstanceCapacity)
+        m_InstanceCapacity = count > m_InstanceCapacity * 2 ? count : m_InstanceCapacity * 2;
+    // respecifying the storage orphans it, so we don't wait on the previous draw
+    glBufferData(GL_ARRAY_BUFFER, m_InstanceCapacity * sizeof(SpriteInstance), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(SpriteInstance), m_Instances.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_BatchShader.Bind();
+    m_Sprites.Bind(0);
+
+    GLState::BindVertexArray(m_BatchVAO);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, count);
+    m_Stats.DrawCalls++;
+
+    m_Instances.clear();
+}
+
+void SpriteRenderer::ResetStats()
+{
+    m_Stats = RenderStats();
+    GLState::ResetStats();
 }
\ No newline at end of file
@@ -1,23 +1,82 @@
 #pragma once
 
+#include <vector>
+
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 
 #include "Shader.h"
-#include "Texture.h"
+#include "TextureArray.h"
+
+// per-instance data for the batched path, laid out to match the
+// attribute pointers set up in SpriteRenderer::InitBatchData
+struct SpriteInstance
+{
+    glm::vec2 Position;
+    glm::vec2 Size;
+    glm::vec3 Color;
+    float     Rotation;
+    float     Layer; // sprite, i.e. layer of the sprite array
+};
+
+class SpriteBuffer;
+
+struct RenderStats
+{
+    unsigned int DrawCalls;
+    unsigned int Sprites;
+};
 
 class SpriteRenderer
 {
 private:
     Shader       m_Shader;
+    Shader       m_BatchShader;
+    // per-draw uniforms of m_Shader, looked up once
+    Uniform      m_ModelUniform;
+    Uniform      m_ColorUniform;
+    Uniform      m_LayerUniform;
+    // every sprite is a layer of this one texture, so nothing ever switches textures
+    const TextureArray& m_Sprites;
     unsigned int m_QuadVAO;
+    unsigned int m_QuadVBO;
+
+    // batched mode: sprites are queued between BeginBatch and EndBatch and drawn
+    // with one instanced draw
+    bool                        m_Batching;
+    unsigned int                m_BatchVAO;
+    unsigned int                m_InstanceVBO;
+    unsigned int                m_InstanceCapacity;
+    std::vector<SpriteInstance> m_Instances;
+
+    RenderStats  m_Stats;
 
     void InitRenderData();
+    void InitBatchData();
+    void InitInstanceAttributes(unsigned int vao, unsigned int instanceVBO);
+    void FlushBatch();
 public:
-    SpriteRenderer(Shader& shader);
+    // sprites must outlive the renderer
+    SpriteRenderer(const glm::mat4& projection, const TextureArray& sprites);
     ~SpriteRenderer();
 
-    void DrawSprite(Texture& texture, glm::vec2 position,
+    // sprite is a layer of the sprite array
+    void DrawSprite(unsigned int sprite, glm::vec2 position,
         glm::vec2 size = glm::vec2(10.0f, 10.0f), float rotate = 0.0f,
         glm::vec3 color = glm::vec3(1.0f));
+
+    // draw a GPU-resident buffer of instances with one instanced draw
+    void DrawBuffer(SpriteBuffer& buffer);
+
+    void BeginBatch();
+    void EndBatch();
+    // draws what has been queued so far and keeps batching, so a pass can be
+    // timed on its own
+    void Flush();
+    inline bool IsBatching() const { return m_Batching; }
+
+    // counters are accumulated until the next call to ResetStats, which the
+    // game does once at the start of every frame
+    void ResetStats();
+    inline const RenderStats& GetStats() const { return m_Stats; }
 };
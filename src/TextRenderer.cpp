@@ -0,0 +1,216 @@
+#include "TextRenderer.h"
+
+#include <cstddef>
+#include <cstring>
+
+#include <GL/glew.h>
+
+#include "GLState.h"
+
+// the atlas holds ASCII 32 to 127 in a grid of 8x8 cells; 127 is a solid block
+// used for rectangles
+const unsigned int FIRST_GLYPH = 32;
+const unsigned int SOLID_GLYPH = 127;
+const unsigned int ATLAS_COLUMNS = 16;
+const unsigned int ATLAS_ROWS = 6;
+const unsigned int CELL_PIXELS = 8;
+
+// 5x7 font for ASCII 32 to 95, one byte per column, least significant bit at the top
+const unsigned char FONT_5X7[64][5] = {
+    { 0x00, 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x5F, 0x00, 0x00 }, // space !
+    { 0x00, 0x07, 0x00, 0x07, 0x00 }, { 0x14, 0x7F, 0x14, 0x7F, 0x14 }, // " #
+    { 0x24, 0x2A, 0x7F, 0x2A, 0x12 }, { 0x23, 0x13, 0x08, 0x64, 0x62 }, // $ %
+    { 0x36, 0x49, 0x55, 0x22, 0x50 }, { 0x00, 0x05, 0x03, 0x00, 0x00 }, // & '
+    { 0x00, 0x1C, 0x22, 0x41, 0x00 }, { 0x00, 0x41, 0x22, 0x1C, 0x00 }, // ( )
+    { 0x08, 0x2A, 0x1C, 0x2A, 0x08 }, { 0x08, 0x08, 0x3E, 0x08, 0x08 }, // * +
+    { 0x00, 0x50, 0x30, 0x00, 0x00 }, { 0x08, 0x08, 0x08, 0x08, 0x08 }, // , -
+    { 0x00, 0x60, 0x60, 0x00, 0x00 }, { 0x20, 0x10, 0x08, 0x04, 0x02 }, // . /
+    { 0x3E, 0x51, 0x49, 0x45, 0x3E }, { 0x00, 0x42, 0x7F, 0x40, 0x00 }, // 0 1
+    { 0x42, 0x61, 0x51, 0x49, 0x46 }, { 0x21, 0x41, 0x45, 0x4B, 0x31 }, // 2 3
+    { 0x18, 0x14, 0x12, 0x7F, 0x10 }, { 0x27, 0x45, 0x45, 0x45, 0x39 }, // 4 5
+    { 0x3C, 0x4A, 0x49, 0x49, 0x30 }, { 0x01, 0x71, 0x09, 0x05, 0x03 }, // 6 7
+    { 0x36, 0x49, 0x49, 0x49, 0x36 }, { 0x06, 0x49, 0x49, 0x29, 0x1E }, // 8 9
+    { 0x00, 0x36, 0x36, 0x00, 0x00 }, { 0x00, 0x56, 0x36, 0x00, 0x00 }, // : ;
+    { 0x08, 0x14, 0x22, 0x41, 0x00 }, { 0x14, 0x14, 0x14, 0x14, 0x14 }, // < =
+    { 0x00, 0x41, 0x22, 0x14, 0x08 }, { 0x02, 0x01, 0x51, 0x09, 0x06 }, // > ?
+    { 0x32, 0x49, 0x79, 0x41, 0x3E }, { 0x7E, 0x11, 0x11, 0x11, 0x7E }, // @ A
+    { 0x7F, 0x49, 0x49, 0x49, 0x36 }, { 0x3E, 0x41, 0x41, 0x41, 0x22 }, // B C
+    { 0x7F, 0x41, 0x41, 0x22, 0x1C }, { 0x7F, 0x49, 0x49, 0x49, 0x41 }, // D E
+    { 0x7F, 0x09, 0x09, 0x09, 0x01 }, { 0x3E, 0x41, 0x49, 0x49, 0x7A }, // F G
+    { 0x7F, 0x08, 0x08, 0x08, 0x7F }, { 0x00, 0x41, 0x7F, 0x41, 0x00 }, // H I
+    { 0x20, 0x40, 0x41, 0x3F, 0x01 }, { 0x7F, 0x08, 0x14, 0x22, 0x41 }, // J K
+    { 0x7F, 0x40, 0x40, 0x40, 0x40 }, { 0x7F, 0x02, 0x0C, 0x02, 0x7F }, // L M
+    { 0x7F, 0x04, 0x08, 0x10, 0x7F }, { 0x3E, 0x41, 0x41, 0x41, 0x3E }, // N O
+    { 0x7F, 0x09, 0x09, 0x09, 0x06 }, { 0x3E, 0x41, 0x51, 0x21, 0x5E }, // P Q
+    { 0x7F, 0x09, 0x19, 0x29, 0x46 }, { 0x46, 0x49, 0x49, 0x49, 0x31 }, // R S
+    { 0x01, 0x01, 0x7F, 0x01, 0x01 }, { 0x3F, 0x40, 0x40, 0x40, 0x3F }, // T U
+    { 0x1F, 0x20, 0x40, 0x20, 0x1F }, { 0x3F, 0x40, 0x38, 0x40, 0x3F }, // V W
+    { 0x63, 0x14, 0x08, 0x14, 0x63 }, { 0x07, 0x08, 0x70, 0x08, 0x07 }, // X Y
+    { 0x61, 0x51, 0x49, 0x45, 0x43 }, { 0x00, 0x7F, 0x41, 0x41, 0x00 }, // Z [
+    { 0x02, 0x04, 0x08, 0x10, 0x20 }, { 0x00, 0x41, 0x41, 0x7F, 0x00 }, // \ ]
+    { 0x04, 0x02, 0x01, 0x02, 0x04 }, { 0x40, 0x40, 0x40, 0x40, 0x40 }, // ^ _
+};
+
+static unsigned int GlyphIndex(char c)
+{
+    unsigned int code = static_cast<unsigned char>(c);
+    if (code >= 'a' && code <= 'z')
+        code -= 'a' - 'A';
+    // anything the font doesn't have is drawn as ?
+    if (code < FIRST_GLYPH || code > SOLID_GLYPH || (code >= FIRST_GLYPH + 64 && code != SOLID_GLYPH))
+        code = '?';
+    return code - FIRST_GLYPH;
+}
+
+static glm::vec2 GlyphCell(unsigned int index)
+{
+    return glm::vec2(static_cast<float>(index % ATLAS_COLUMNS) / ATLAS_COLUMNS,
+        static_cast<float>(index / ATLAS_COLUMNS) / ATLAS_ROWS);
+}
+
+TextRenderer::TextRenderer(const glm::mat4& projection)
+    : m_Shader("res/shaders/text_vertex.shader", "res/shaders/text_fragment.shader"),
+    m_FontTexture(0), m_QuadVBO(0), m_VAO(0), m_InstanceVBO(0), m_InstanceCapacity(0)
+{
+    m_Shader.Bind();
+    m_Shader.SetUniform1i("font", 0);
+    m_Shader.SetUniformMat4f("projection", projection);
+    m_Shader.SetUniform2f("cellSize", glm::vec2(1.0f / ATLAS_COLUMNS, 1.0f / ATLAS_ROWS));
+
+    InitFont();
+
+    float vertices[] = {
+        // pos      // texture coords
+        0.0f, 1.0f, 0.0f, 1.0f,
+        1.0f, 0.0f, 1.0f, 0.0f,
+        0.0f, 0.0f, 0.0f, 0.0f,
+
+        0.0f, 1.0f, 0.0f, 1.0f,
+        1.0f, 1.0f, 1.0f, 1.0f,
+        1.0f, 0.0f, 1.0f, 0.0f
+    };
+
+    glGenVertexArrays(1, &m_VAO);
+    glGenBuffers(1, &m_QuadVBO);
+    glGenBuffers(1, &m_InstanceVBO);
+
+    GLState::BindVertexArray(m_VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_QuadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_InstanceVBO);
+    // position + size
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(GlyphInstance),
+        (void*)offsetof(GlyphInstance, Position));
+    glVertexAttribDivisor(1, 1);
+    // atlas cell
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(GlyphInstance),
+        (void*)offsetof(GlyphInstance, Cell));
+    glVertexAttribDivisor(2, 1);
+    // color
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(GlyphInstance),
+        (void*)offsetof(GlyphInstance, Color));
+    glVertexAttribDivisor(3, 1);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GLState::BindVertexArray(0);
+}
+
+TextRenderer::~TextRenderer()
+{
+    GLState::DeleteVertexArray(m_VAO);
+    GLState::DeleteTexture(m_FontTexture);
+    glDeleteBuffers(1, &m_QuadVBO);
+    glDeleteBuffers(1, &m_InstanceVBO);
+}
+
+void TextRenderer::InitFont()
+{
+    const unsigned int width = ATLAS_COLUMNS * CELL_PIXELS;
+    const unsigned int height = ATLAS_ROWS * CELL_PIXELS;
+    std::vector<unsigned char> texels(width * height, 0);
+
+    for (unsigned int glyph = 0; glyph <= SOLID_GLYPH - FIRST_GLYPH; ++glyph)
+    {
+        unsigned int originX = (glyph % ATLAS_COLUMNS) * CELL_PIXELS;
+        unsigned int originY = (glyph / ATLAS_COLUMNS) * CELL_PIXELS;
+        for (unsigned int y = 0; y < CELL_PIXELS; ++y)
+        {
+            for (unsigned int x = 0; x < CELL_PIXELS; ++x)
+            {
+                bool set;
+                if (glyph == SOLID_GLYPH - FIRST_GLYPH)
+                    set = true;
+                else if (glyph < 64)
+                    set = x < 5 && y < 7 && (FONT_5X7[glyph][x] >> y) & 1;
+                else
+                    set = false;
+                texels[(originY + y) * width + originX + x] = set ? 255 : 0;
+            }
+        }
+    }
+
+    glGenTextures(1, &m_FontTexture);
+    GLState::ActiveTexture(0);
+    GLState::BindTexture(GL_TEXTURE_2D, m_FontTexture);
+    // rows of the single-channel atlas aren't padded to 4 bytes
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, texels.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    // font pixels stay square at any scale
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+void TextRenderer::DrawText(const char* text, glm::vec2 position, float scale, glm::vec4 color)
+{
+    glm::vec2 size(CELL_PIXELS * scale);
+    for (; *text; ++text)
+    {
+        char c = *text;
+        if (c != ' ')
+            m_Glyphs.push_back({ position, size, GlyphCell(GlyphIndex(c)), color });
+        position.x += GLYPH_ADVANCE * scale;
+    }
+}
+
+void TextRenderer::DrawRect(glm::vec2 position, glm::vec2 size, glm::vec4 color)
+{
+    m_Glyphs.push_back({ position, size, GlyphCell(SOLID_GLYPH - FIRST_GLYPH), color });
+}
+
+void TextRenderer::Flush()
+{
+    if (m_Glyphs.empty())
+        return;
+
+    unsigned int count = static_cast<unsigned int>(m_Glyphs.size());
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_InstanceVBO);
+    if (count > m_InstanceCapacity)
+        m_InstanceCapacity = count > m_InstanceCapacity * 2 ? count : m_InstanceCapacity * 2;
+    // orphan the storage so the previous frame's draw isn't waited on
+    glBufferData(GL_ARRAY_BUFFER, m_InstanceCapacity * sizeof(GlyphInstance), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(GlyphInstance), m_Glyphs.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_Shader.Bind();
+    GLState::ActiveTexture(0);
+    GLState::BindTexture(GL_TEXTURE_2D, m_FontTexture);
+    GLState::BindVertexArray(m_VAO);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, count);
+
+    m_Glyphs.clear();
+}
+
+float TextRenderer::TextWidth(const char* text, float scale)
+{
+    return std::strlen(text) * GLYPH_ADVANCE * scale;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "Shader.h"
+
+// per-instance data of one glyph, laid out to match the attribute pointers
+// set up in the TextRenderer constructor
+struct GlyphInstance
+{
+    glm::vec2 Position;
+    glm::vec2 Size;
+    glm::vec2 Cell;
+    glm::vec4 Color;
+};
+
+// Draws text from a built-in 5x7 pixel font. The font is baked into a small
+// single-channel atlas at startup, so there is nothing to load. Text and
+// rectangles are queued and drawn with one instanced draw per Flush.
+// Lowercase letters are drawn as uppercase.
+class TextRenderer
+{
+public:
+    // a glyph is drawn in a cell this many font pixels across, spacing included
+    static const unsigned int GLYPH_ADVANCE = 6;
+    static const unsigned int GLYPH_HEIGHT = 8;
+private:
+    Shader       m_Shader;
+    unsigned int m_FontTexture;
+    unsigned int m_QuadVBO;
+    unsigned int m_VAO;
+    unsigned int m_InstanceVBO;
+    unsigned int m_InstanceCapacity;
+    std::vector<GlyphInstance> m_Glyphs;
+
+    void InitFont();
+public:
+    explicit TextRenderer(const glm::mat4& projection);
+    ~TextRenderer();
+
+    TextRenderer(const TextRenderer&) = delete;
+    TextRenderer& operator=(const TextRenderer&) = delete;
+
+    // position is the top left of the first glyph; scale is the size of a font pixel.
+    // Text is a plain C string so per-frame text can be formatted into a fixed buffer
+    void DrawText(const char* text, glm::vec2 position, float scale = 1.0f,
+        glm::vec4 color = glm::vec4(1.0f));
+    void DrawRect(glm::vec2 position, glm::vec2 size, glm::vec4 color);
+    void Flush();
+
+    // width in pixels of a line of text at scale
+    static float TextWidth(const char* text, float scale = 1.0f);
+};
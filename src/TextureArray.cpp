@@ -0,0 +1,46 @@
+#include "TextureArray.h"
+
+#include <GL/glew.h>
+
+#include "GLState.h"
+
+TextureArray::TextureArray(const TexturePack& pack, TextureStreamer& streamer)
+	: m_ID(0), m_Layers(pack.LayerCount()), m_Width(pack.LayerWidth),
+	m_Height(pack.LayerHeight), m_Ticket(0)
+{
+	glGenTextures(1, &m_ID);
+	GLState::BindTexture(GL_TEXTURE_2D_ARRAY, m_ID);
+
+	// linear filtering, no tiling
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	// allocate only, the texels follow through the streamer
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, m_Width, m_Height, m_Layers, 0,
+		GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+	size_t layerBytes = static_cast<size_t>(m_Width) * m_Height * 4;
+	for (unsigned int layer = 0; layer < pack.LayerCount(); ++layer)
+		UploadLayer(streamer, layer, pack.Pixels + layer * layerBytes);
+
+	GLState::BindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void TextureArray::UploadLayer(TextureStreamer& streamer, unsigned int layer, const unsigned char* rgba)
+{
+	if (layer < m_Layers)
+		m_Ticket = streamer.UploadLayer(m_ID, layer, m_Width, m_Height, rgba);
+}
+
+TextureArray::~TextureArray()
+{
+	GLState::DeleteTexture(m_ID);
+}
+
+void TextureArray::Bind(unsigned int slot) const
+{
+	GLState::ActiveTexture(slot);
+	GLState::BindTexture(GL_TEXTURE_2D_ARRAY, m_ID);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "TexturePack.h"
+#include "TextureStreamer.h"
+
+struct TextureResidency
+{
+	unsigned int Layers;
+	size_t       Bytes; // GPU memory of every layer, RGBA8 with no mipmaps
+};
+
+// A GL_TEXTURE_2D_ARRAY holding every layer of a TexturePack. Layers can be
+// replaced later, e.g. to swap in a new brick skin mid-game. The pack can be
+// destroyed once this is constructed.
+class TextureArray
+{
+private:
+	unsigned int m_ID;
+	unsigned int m_Layers;
+	unsigned int m_Width, m_Height;
+	// ticket of the last layer upload, see TextureStreamer
+	unsigned int m_Ticket;
+public:
+	// the layers are streamed in through streamer rather than uploaded in place
+	TextureArray(const TexturePack& pack, TextureStreamer& streamer);
+	~TextureArray();
+
+	TextureArray(const TextureArray&) = delete;
+	TextureArray& operator=(const TextureArray&) = delete;
+
+	void Bind(unsigned int slot = 0) const;
+
+	// replaces a layer with LayerWidth * LayerHeight RGBA8 texels, without stalling
+	// the frame; IsReady says when every upload so far has reached the texture
+	void UploadLayer(TextureStreamer& streamer, unsigned int layer, const unsigned char* rgba);
+	inline bool IsReady(const TextureStreamer& streamer) const { return streamer.IsReady(m_Ticket); }
+
+	inline unsigned int GetID() const { return m_ID; }
+	inline unsigned int GetLayerCount() const { return m_Layers; }
+	inline TextureResidency GetResidency() const
+	{
+		return { m_Layers, static_cast<size_t>(m_Width) * m_Height * 4 * m_Layers };
+	}
+};
@@ -0,0 +1,220 @@
+#include "TexturePack.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include "Profiler.h"
+
+#include "stb_image/stb_image.h"
+
+static const char TEXTURE_PACK_MAGIC[4] = { 'B', 'R', 'K', 'T' };
+static const uint16_t TEXTURE_PACK_VERSION = 1;
+
+struct TexturePackHeader
+{
+    char     Magic[4];
+    uint16_t Version;
+    uint16_t Reserved;
+    uint32_t Width;
+    uint32_t Height;
+    uint32_t Layers;
+};
+static_assert(sizeof(TexturePackHeader) == 20, "TexturePackHeader must match the on-disk layout");
+
+// bilinear resample of an RGBA8 image, sampling texel centers
+static void Resample(const unsigned char* src, int srcWidth, int srcHeight,
+    unsigned char* dst, unsigned int dstWidth, unsigned int dstHeight)
+{
+    for (unsigned int y = 0; y < dstHeight; ++y)
+    {
+        float sy = std::max((y + 0.5f) * srcHeight / dstHeight - 0.5f, 0.0f);
+        int y0 = std::min(static_cast<int>(sy), srcHeight - 1);
+        int y1 = std::min(y0 + 1, srcHeight - 1);
+        float fy = sy - y0;
+        for (unsigned int x = 0; x < dstWidth; ++x)
+        {
+            float sx = std::max((x + 0.5f) * srcWidth / dstWidth - 0.5f, 0.0f);
+            int x0 = std::min(static_cast<int>(sx), srcWidth - 1);
+            int x1 = std::min(x0 + 1, srcWidth - 1);
+            float fx = sx - x0;
+            for (int c = 0; c < 4; ++c)
+            {
+                float top = src[(y0 * srcWidth + x0) * 4 + c] * (1.0f - fx) + src[(y0 * srcWidth + x1) * 4 + c] * fx;
+                float bottom = src[(y1 * srcWidth + x0) * 4 + c] * (1.0f - fx) + src[(y1 * srcWidth + x1) * 4 + c] * fx;
+                dst[(y * dstWidth + x) * 4 + c] = static_cast<unsigned char>(top * (1.0f - fy) + bottom * fy + 0.5f);
+            }
+        }
+    }
+}
+
+TexturePack::TexturePack()
+    : LayerWidth(0), LayerHeight(0), Pixels(nullptr)
+{
+
+}
+
+bool TexturePack::Build(const std::string& directory, unsigned int layerWidth, unsigned int layerHeight)
+{
+    AssetLoader loader;
+    QueueBuild(directory, loader, layerWidth, layerHeight);
+    loader.Run(nullptr);
+    return FinishBuild();
+}
+
+void TexturePack::QueueBuild(const std::string& directory, AssetLoader& loader,
+    unsigned int layerWidth, unsigned int layerHeight)
+{
+    Names.clear();
+    m_Built.clear();
+    Pixels = nullptr;
+    LayerWidth = layerWidth;
+    LayerHeight = layerHeight;
+
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+    {
+        std::string extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if (extension == ".png" || extension == ".jpg" || extension == ".jpeg" ||
+            extension == ".bmp" || extension == ".tga")
+            Names.push_back(entry.path().filename().string());
+    }
+    // sorted so a layer index means the same image on every machine
+    std::sort(Names.begin(), Names.end());
+
+    // every image decodes straight into its own layer, so the jobs share nothing
+    size_t layerBytes = static_cast<size_t>(layerWidth) * layerHeight * 4;
+    m_Built.resize(layerBytes * Names.size());
+    for (size_t i = 0; i < Names.size(); ++i)
+    {
+        loader.Add([this, directory, i, layerBytes]()
+        {
+            PROFILE_ZONE("DecodeImage");
+            std::string path = directory + "/" + Names[i];
+            int width, height, bpp;
+            unsigned char* image = stbi_load(path.c_str(), &width, &height, &bpp, 4);
+            if (!image)
+            {
+                // FinishBuild drops layers left without a name
+                std::cout << "TEXTURE FAILED TO LOAD: " << path << std::endl;
+                Names[i].clear();
+                return;
+            }
+            Resample(image, width, height, m_Built.data() + i * layerBytes, LayerWidth, LayerHeight);
+            stbi_image_free(image);
+        });
+    }
+}
+
+bool TexturePack::FinishBuild()
+{
+    size_t layerBytes = static_cast<size_t>(LayerWidth) * LayerHeight * 4;
+    size_t kept = 0;
+    for (size_t i = 0; i < Names.size(); ++i)
+    {
+        if (Names[i].empty())
+            continue;
+        if (kept != i)
+        {
+            Names[kept] = Names[i];
+            std::memmove(m_Built.data() + kept * layerBytes, m_Built.data() + i * layerBytes, layerBytes);
+        }
+        kept++;
+    }
+    Names.resize(kept);
+    m_Built.resize(kept * layerBytes);
+
+    Pixels = m_Built.data();
+    return !Names.empty();
+}
+
+bool TexturePack::Read(const char* path)
+{
+    Names.clear();
+    m_Built.clear();
+    Pixels = nullptr;
+    LayerWidth = LayerHeight = 0;
+
+    if (!m_File.Open(path))
+        return false;
+
+    TexturePackHeader header;
+    const unsigned char* data = m_File.Data();
+    size_t size = m_File.Size();
+    if (size < sizeof(header))
+        return false;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.Magic, TEXTURE_PACK_MAGIC, sizeof(TEXTURE_PACK_MAGIC)) != 0 ||
+        header.Version != TEXTURE_PACK_VERSION)
+    {
+        std::cout << "NOT A TEXTURE PACK: " << path << std::endl;
+        return false;
+    }
+
+    size_t offset = sizeof(header);
+    for (uint32_t i = 0; i < header.Layers; ++i)
+    {
+        uint16_t length;
+        if (offset + sizeof(length) > size)
+            break;
+        std::memcpy(&length, data + offset, sizeof(length));
+        offset += sizeof(length);
+        if (offset + length > size)
+            break;
+        Names.push_back(std::string(reinterpret_cast<const char*>(data + offset), length));
+        offset += length;
+    }
+    offset = (offset + 3) & ~size_t(3);
+
+    uint64_t pixelBytes = static_cast<uint64_t>(header.Width) * header.Height * 4 * header.Layers;
+    if (Names.size() != header.Layers || offset + pixelBytes > size)
+    {
+        std::cout << "TEXTURE PACK TRUNCATED: " << path << std::endl;
+        Names.clear();
+        return false;
+    }
+
+    LayerWidth = header.Width;
+    LayerHeight = header.Height;
+    Pixels = data + offset;
+    return !Names.empty();
+}
+
+bool TexturePack::Write(const char* path) const
+{
+    TexturePackHeader header;
+    std::memcpy(header.Magic, TEXTURE_PACK_MAGIC, sizeof(TEXTURE_PACK_MAGIC));
+    header.Version = TEXTURE_PACK_VERSION;
+    header.Reserved = 0;
+    header.Width = LayerWidth;
+    header.Height = LayerHeight;
+    header.Layers = LayerCount();
+
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    size_t offset = sizeof(header);
+    for (const std::string& name : Names)
+    {
+        uint16_t length = static_cast<uint16_t>(name.size());
+        out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.write(name.data(), length);
+        offset += sizeof(length) + length;
+    }
+    const char padding[4] = {};
+    out.write(padding, ((offset + 3) & ~size_t(3)) - offset);
+    out.write(reinterpret_cast<const char*>(Pixels), static_cast<size_t>(LayerWidth) * LayerHeight * 4 * LayerCount());
+    return static_cast<bool>(out);
+}
+
+unsigned int TexturePack::Find(const std::string& name) const
+{
+    for (unsigned int i = 0; i < LayerCount(); ++i)
+        if (Names[i] == name)
+            return i;
+    std::cout << "SPRITE NOT IN TEXTURE PACK: " << name << std::endl;
+    return 0;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "AssetLoader.h"
+#include "MappedFile.h"
+
+// sprites are small on screen, 256x256 texels per layer is plenty
+const unsigned int TEXTURE_PACK_LAYER_SIZE = 256;
+
+// Every sprite image resampled to one size and stacked as the layers of a
+// GL_TEXTURE_2D_ARRAY, so all sprites can be drawn without switching
+// textures. Sprites are stretched over their quad anyway, so resampling to a
+// common size only trades some texels for a single binding.
+//
+// Build decodes a directory of images; Write saves the result as a .pak that
+// Read maps back in with no decoding:
+//
+//   "BRKT" | uint16 version | uint16 0 | uint32 width, height, layers
+//   per layer: uint16 name length, name bytes
+//   zero padding to a multiple of 4, then layers * width * height RGBA8 texels
+class TexturePack
+{
+private:
+    MappedFile                 m_File;
+    std::vector<unsigned char> m_Built;
+public:
+    unsigned int             LayerWidth, LayerHeight;
+    // file name of each layer's source image, without the directory
+    std::vector<std::string> Names;
+    // RGBA8 texels of every layer, owned by the pack
+    const unsigned char*     Pixels;
+
+    TexturePack();
+
+    TexturePack(const TexturePack&) = delete;
+    TexturePack& operator=(const TexturePack&) = delete;
+
+    // packs every .png/.jpg/.bmp/.tga in directory, sorted by name
+    bool Build(const std::string& directory, unsigned int layerWidth = TEXTURE_PACK_LAYER_SIZE,
+        unsigned int layerHeight = TEXTURE_PACK_LAYER_SIZE);
+    // Build split in two so the decoding can run alongside other loading:
+    // QueueBuild adds one decode job per image to loader, FinishBuild drops the
+    // images that failed to decode once the loader has run.
+    void QueueBuild(const std::string& directory, AssetLoader& loader,
+        unsigned int layerWidth = TEXTURE_PACK_LAYER_SIZE, unsigned int layerHeight = TEXTURE_PACK_LAYER_SIZE);
+    bool FinishBuild();
+    bool Read(const char* path);
+    bool Write(const char* path) const;
+
+    inline unsigned int LayerCount() const { return static_cast<unsigned int>(Names.size()); }
+    // layer of the image with this file name, 0 (the first layer) if there is none
+    unsigned int Find(const std::string& name) const;
+};
@@ -0,0 +1,81 @@
+#include "TextureStreamer.h"
+
+#include <cstring>
+#include <iostream>
+
+#include "GLState.h"
+
+TextureStreamer::TextureStreamer()
+    : m_PBO(0), m_Capacity(0), m_NextTicket(1), m_Completed(0), m_Stats()
+{
+    glGenBuffers(1, &m_PBO);
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    for (Pending& pending : m_Pending)
+        glDeleteSync(pending.Fence);
+    glDeleteBuffers(1, &m_PBO);
+}
+
+bool TextureStreamer::Stage(const unsigned char* data, size_t size)
+{
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_PBO);
+    // respecifying the storage orphans the previous upload's copy, so the
+    // driver hands us fresh memory instead of waiting for that transfer
+    if (size > m_Capacity)
+        m_Capacity = size;
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, m_Capacity, nullptr, GL_STREAM_DRAW);
+    void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (mapped)
+    {
+        std::memcpy(mapped, data, size);
+        // the store can be lost, e.g. on a mode switch, and then the texels are garbage
+        if (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE)
+            return true;
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    return false;
+}
+
+unsigned int TextureStreamer::Fence()
+{
+    unsigned int ticket = m_NextTicket++;
+    m_Pending.push_back({ ticket, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) });
+    return ticket;
+}
+
+unsigned int TextureStreamer::UploadLayer(unsigned int arrayTexture, unsigned int layer,
+    unsigned int width, unsigned int height, const unsigned char* rgba)
+{
+    size_t size = static_cast<size_t>(width) * height * 4;
+    bool staged = Stage(rgba, size);
+    if (!staged)
+        std::cout << "TEXTURE STREAMING FAILED, UPLOADING LAYER " << layer << " DIRECTLY" << std::endl;
+
+    GLState::BindTexture(GL_TEXTURE_2D_ARRAY, arrayTexture);
+    // with a buffer bound the pointer argument is an offset into it
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, width, height, 1,
+        GL_RGBA, GL_UNSIGNED_BYTE, staged ? nullptr : rgba);
+    // client-memory uploads elsewhere would read from the buffer while it's bound
+    if (staged)
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    m_Stats.Uploads++;
+    m_Stats.Bytes += size;
+    return Fence();
+}
+
+void TextureStreamer::Poll()
+{
+    while (!m_Pending.empty())
+    {
+        GLenum status = glClientWaitSync(m_Pending.front().Fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+            break;
+        m_Completed = m_Pending.front().Ticket;
+        glDeleteSync(m_Pending.front().Fence);
+        m_Pending.pop_front();
+    }
+}
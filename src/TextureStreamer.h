@@ -0,0 +1,58 @@
+#pragma once
+
+#include <deque>
+
+#include <GL/glew.h>
+
+struct TextureStreamerStats
+{
+    unsigned int Uploads;
+    size_t       Bytes;
+};
+
+// Uploads texels through a pixel unpack buffer instead of straight from client
+// memory. The copy into the buffer is a memcpy into freshly orphaned storage, so
+// it never waits on the GPU, and the driver moves the data to the texture
+// asynchronously. Every upload gets a ticket and a fence; Poll retires the
+// fences that have signaled, so IsReady tells when a texture can be swapped
+// in without the draw that uses it waiting on the transfer.
+class TextureStreamer
+{
+private:
+    struct Pending
+    {
+        unsigned int Ticket;
+        GLsync       Fence;
+    };
+
+    unsigned int         m_PBO;
+    size_t               m_Capacity;
+    unsigned int         m_NextTicket;
+    // fences signal in submission order, so everything up to here is done
+    unsigned int         m_Completed;
+    std::deque<Pending>  m_Pending;
+    TextureStreamerStats m_Stats;
+
+    // copies size bytes into the buffer, which is left bound to GL_PIXEL_UNPACK_BUFFER;
+    // false with nothing bound if the buffer could not be mapped or written
+    bool Stage(const unsigned char* data, size_t size);
+    unsigned int Fence();
+public:
+    TextureStreamer();
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // replaces one layer of a GL_TEXTURE_2D_ARRAY with width * height RGBA8 texels;
+    // rgba can be freed as soon as this returns. If staging fails the layer is
+    // uploaded straight from rgba instead, which may stall
+    unsigned int UploadLayer(unsigned int arrayTexture, unsigned int layer,
+        unsigned int width, unsigned int height, const unsigned char* rgba);
+
+    // retires finished uploads without blocking; call once a frame
+    void Poll();
+    inline bool IsReady(unsigned int ticket) const { return ticket <= m_Completed; }
+
+    inline const TextureStreamerStats& GetStats() const { return m_Stats; }
+};